@@ -5,38 +5,93 @@
  *      Date:       2025
  */
 #include "MCP41HVX1.h"
+#ifndef MCP41HVX1_NO_FLOAT
 #include "math.h"
+#endif
+#include "MCP41HVX1_Transport.h"
+#include "MCP41HVX1_Variant.h"
 #include "stdint.h"
 
 #define __MCP_SELECT(__MCP__) ((__MCP__)->csPort->BSRR = (uint32_t)((__MCP__)->csPin << 16))
 #define __MCP_UNSELECT(__MCP__) ((__MCP__)->csPort->BSRR = (__MCP__)->csPin)
 
-static uint8_t old_spi_polarity;
-static uint8_t old_spi_phase;
+// Compile-time expansion of the wiper write frame table. Each frame is the
+// write data command for the wiper register (0x00) followed by the code.
+#define _MCP_FRAME(c) { 0x00, (uint8_t)(c) }
+#define _MCP_FRAMES_4(c)                                                                           \
+    _MCP_FRAME (c), _MCP_FRAME ((c) + 1), _MCP_FRAME ((c) + 2), _MCP_FRAME ((c) + 3)
+#define _MCP_FRAMES_16(c)                                                                          \
+    _MCP_FRAMES_4 (c), _MCP_FRAMES_4 ((c) + 4), _MCP_FRAMES_4 ((c) + 8), _MCP_FRAMES_4 ((c) + 12)
+#define _MCP_FRAMES_64(c)                                                                          \
+    _MCP_FRAMES_16 (c), _MCP_FRAMES_16 ((c) + 16), _MCP_FRAMES_16 ((c) + 32),                      \
+        _MCP_FRAMES_16 ((c) + 48)
+#define _MCP_FRAMES_256(c)                                                                         \
+    _MCP_FRAMES_64 (c), _MCP_FRAMES_64 ((c) + 64), _MCP_FRAMES_64 ((c) + 128),                     \
+        _MCP_FRAMES_64 ((c) + 192)
+
+const uint8_t MCP41HVX1_Frame_Table[MCP_FSV + 1][2] = { _MCP_FRAMES_256 (0) };
+
+// Clock feeding the SPI peripheral's baud rate generator. SPI2 and SPI3
+// hang off APB1, every other SPI off APB2.
+#ifdef MCP41HVX1_HOST
+#define __MCP_SPI_CLOCK(__INSTANCE__) (MCP_HOST_PCLK)
+#else
+#define __MCP_SPI_CLOCK(__INSTANCE__)                                                              \
+    (((__INSTANCE__) == SPI2 || (__INSTANCE__) == SPI3) ? HAL_RCC_GetPCLK1Freq ()                  \
+                                                        : HAL_RCC_GetPCLK2Freq ())
+#endif
 
-static void
+/**
+ *  uint32_t MCP41HVX1_Reg_Baud(MCP41HVX1 *mcp)
+ *
+ *  Work out the SPI CR1 baud rate bits (BR, bits 5:3) giving the fastest
+ *  SCK within the device's maxSckHz from the current bus clock. SCK is the
+ *  bus clock divided by 2^(BR + 1), if even the slowest is too fast it is
+ *  used anyway.
+ *
+ *  Returns the BR bits in place, or the handle's own when maxSckHz is 0.
+ */
+uint32_t
+MCP41HVX1_Reg_Baud (MCP41HVX1 *mcp)
+{
+    if (mcp->maxSckHz == 0)
+    {
+        return mcp->spiHandle->Instance->CR1 & 0x0038;
+    }
+
+    uint32_t clock = __MCP_SPI_CLOCK (mcp->spiHandle->Instance);
+    uint32_t br = 0;
+    while (br < 7 && (clock >> (br + 1)) > mcp->maxSckHz)
+        br++;
+
+    return br << 3;
+}
+
+static uint32_t
 _spi_change_settings (MCP41HVX1 *mcp)
 {
-    // Store the original values
-    old_spi_polarity = ((mcp->spiHandle->Instance->CR1 & 0x0002) >> 1);
-    old_spi_phase = (mcp->spiHandle->Instance->CR1 & 0x0001);
+    // Keep the original values for _spi_revert_settings
+    uint32_t mode = mcp->spiHandle->Instance->CR1 & 0x003B;
 
     // Update to values required for MCP operation: clear
     // the polarity bit and clear the phase bit.
     mcp->spiHandle->Instance->CR1 &= ~0x0002;
     mcp->spiHandle->Instance->CR1 &= ~0x0001;
+
+    // Run at the fastest baud rate the device allows, regardless of
+    // what the handle was set up for by other devices on the bus
+    uint32_t baud = MCP41HVX1_Reg_Baud (mcp);
+    mcp->spiHandle->Instance->CR1 = (mcp->spiHandle->Instance->CR1 & ~0x0038) | baud;
+
+    return mode;
 }
 
 static void
-_spi_revert_settings (MCP41HVX1 *mcp)
+_spi_revert_settings (MCP41HVX1 *mcp, uint32_t mode)
 {
-    // Revert the spi handle's settings to what was
-    // originally stored by _spi_change_settings
-    if (old_spi_polarity)
-        mcp->spiHandle->Instance->CR1 |= 0x0002;
-
-    if (old_spi_phase)
-        mcp->spiHandle->Instance->CR1 |= 0x0001;
+    // Revert the spi handle's polarity, phase and baud rate to
+    // what was returned by _spi_change_settings
+    mcp->spiHandle->Instance->CR1 = (mcp->spiHandle->Instance->CR1 & ~0x003B) | mode;
 }
 
 /**
@@ -74,51 +129,316 @@ _spi_disable (SPI_HandleTypeDef *spiHandle)
     return HAL_OK;
 }
 
+// Cycle counter timing waits, not counted on a host
+#ifndef MCP41HVX1_HOST
+#define __MCP_CYCLES() (DWT->CYCCNT)
+#else
+#define __MCP_CYCLES() (0U)
+#endif
+
+/**
+ *  void _spi_wait(MCP41HVX1 *mcp, MCP41HVX1_Wait *wait, uint32_t flag)
+ *
+ *  Wait for an SPI status flag (RXNE 0x0001 or TXE 0x0002) to be set the
+ *  way the wait strategy says, spinning if it is NULL.
+ */
 static void
-_spi_16bit_write (MCP41HVX1 *mcp, uint16_t data)
+_spi_wait (MCP41HVX1 *mcp, MCP41HVX1_Wait *wait, uint32_t flag)
 {
-    // Wait until the SPI transmit buffer is empty
-    while (!(mcp->spiHandle->Instance->SR & 0x0002))
-        ;
+    SPI_TypeDef *spi = mcp->spiHandle->Instance;
+    if (wait == NULL)
+    {
+        while (!(spi->SR & flag))
+            ;
 
-    // Send the write data command for the wiper register
-    *((volatile uint8_t *)(&(mcp->spiHandle->Instance->DR))) = (uint8_t)((data & 0xFF00) >> 8);
+        return;
+    }
 
-    // Wait until the SPI transmit buffer is empty
-    while (!(mcp->spiHandle->Instance->SR & 0x0002))
+    uint32_t start = __MCP_CYCLES ();
+    if (!(spi->SR & flag) && wait->strategy == MCP_WAIT_EVENT)
+    {
+#ifndef MCP41HVX1_HOST
+        // RXNEIE (bit 6) or TXEIE (bit 7) pends the SPI interrupt once the
+        // flag is set, which is an event with SEVONPEND. The interrupt must
+        // not be left pending, or the next wait's would raise no event.
+        uint32_t enable = (flag == 0x0001) ? 0x0040 : 0x0080;
+        HAL_NVIC_ClearPendingIRQ (wait->irq);
+        spi->CR2 |= enable;
+
+        while (!(spi->SR & flag))
+        {
+            __WFE ();
+            wait->sleeps++;
+        }
+
+        spi->CR2 &= ~enable;
+        HAL_NVIC_ClearPendingIRQ (wait->irq);
+#endif
+    }
+    else if (!(spi->SR & flag) && wait->strategy == MCP_WAIT_YIELD && wait->yield)
+    {
+        while (!(spi->SR & flag))
+        {
+            wait->yield ();
+            wait->sleeps++;
+        }
+    }
+
+    while (!(spi->SR & flag))
         ;
 
-    // Send the data to be written to the register
-    *((volatile uint8_t *)(&(mcp->spiHandle->Instance->DR))) = (uint8_t)(data & 0x00FF);
+    uint32_t cycles = __MCP_CYCLES () - start;
+    wait->waits++;
+    wait->cycles += cycles;
+    if (cycles > wait->maxCycles)
+        wait->maxCycles = cycles;
 }
 
 static void
-_spi_8bit_read (MCP41HVX1 *mcp, uint8_t *buffer)
+_spi_8bit_read (MCP41HVX1 *mcp, MCP41HVX1_Wait *wait, uint8_t *buffer)
 {
     // Wait until the receive buffer RXNE flag
-    while (!(mcp->spiHandle->Instance->SR & 0x0001))
-        ;
+    _spi_wait (mcp, wait, 0x0001);
 
     // Store the first 8 bits
     *buffer = *(volatile uint8_t *)(&(mcp->spiHandle->Instance->DR));
 }
 
+/**
+ *  Register level transport
+ *
+ *  Drives the STM32F7 SPI peripheral registers directly. This is the
+ *  default transport of devices set up with MCP41HVX1_Init and the only
+ *  one able to run DMA frame streams.
+ */
+HAL_StatusTypeDef
+MCP41HVX1_Reg_Acquire (MCP41HVX1 *mcp)
+{
+    __HAL_LOCK (mcp->spiHandle);
+    mcp->spiMode = _spi_change_settings (mcp);
+
+    // Set the RXNE event to fire when Rx buffer is 1/4 full (8 bits)
+    mcp->spiHandle->Instance->CR2 |= 0x1000;
+
+    // Enable SPI by setting SPE bit (bit 6)
+    mcp->spiHandle->Instance->CR1 |= 0x0040;
+
+    return HAL_OK;
+}
+
+void
+MCP41HVX1_Reg_Release (MCP41HVX1 *mcp)
+{
+    _spi_disable (mcp->spiHandle);
+    _spi_revert_settings (mcp, mcp->spiMode);
+    __HAL_UNLOCK (mcp->spiHandle);
+}
+
+void
+MCP41HVX1_Reg_Select (MCP41HVX1 *mcp)
+{
+    __MCP_SELECT (mcp);
+}
+
+void
+MCP41HVX1_Reg_Unselect (MCP41HVX1 *mcp)
+{
+    __MCP_UNSELECT (mcp);
+}
+
+HAL_StatusTypeDef
+MCP41HVX1_Reg_Transfer (MCP41HVX1 *mcp, const uint8_t *tx, uint8_t *rx, uint16_t len)
+{
+    if (len == 0)
+    {
+        return HAL_OK;
+    }
+
+    // Short transfers spin whatever the device's wait strategy
+    MCP41HVX1_Wait *wait = (mcp->wait && len >= mcp->wait->minBytes) ? mcp->wait : NULL;
+
+    // Wait until the SPI transmit buffer is empty
+    _spi_wait (mcp, wait, 0x0002);
+
+    *((volatile uint8_t *)(&(mcp->spiHandle->Instance->DR))) = tx[0];
+
+    for (uint16_t i = 0; i < len; i++)
+    {
+        // Queue the next byte before collecting this one's
+        // response so the bus never idles between bytes
+        if (i + 1 < len)
+        {
+            _spi_wait (mcp, wait, 0x0002);
+
+            *((volatile uint8_t *)(&(mcp->spiHandle->Instance->DR))) = tx[i + 1];
+        }
+
+        _spi_8bit_read (mcp, wait, &rx[i]);
+    }
+
+    return HAL_OK;
+}
+
+const MCP41HVX1_Transport MCP41HVX1_Reg_Transport = {
+    MCP41HVX1_Reg_Acquire, MCP41HVX1_Reg_Release,  MCP41HVX1_Reg_Select,
+    MCP41HVX1_Reg_Unselect, MCP41HVX1_Reg_Transfer,
+};
+
+/**
+ *  HAL_StatusTypeDef _mcp_command(MCP41HVX1 *mcp, const uint8_t *tx, uint8_t *rx, uint16_t len)
+ *
+ *  Acquire the bus, exchange len bytes with the device within a single
+ *  chip select frame and release the bus again.
+ *
+ *  Returns a HAL_StatusTypeDef indicating success or failure.
+ */
+static HAL_StatusTypeDef
+_mcp_command (MCP41HVX1 *mcp, const uint8_t *tx, uint8_t *rx, uint16_t len)
+{
+    HAL_StatusTypeDef status = __MCP_ACQUIRE (mcp);
+    if (status != HAL_OK)
+    {
+        return status;
+    }
+
+    __MCP_XPORT_SELECT (mcp);
+    status = __MCP_TRANSFER (mcp, tx, rx, len);
+    __MCP_XPORT_UNSELECT (mcp);
+    __MCP_RELEASE (mcp);
+
+    return status;
+}
+
 static void
-_spi_16bit_read (MCP41HVX1 *mcp, uint8_t *buffer)
+_mcp_backoff (uint32_t us)
 {
-    // Wait until the receive buffer RXNE flag
-    while (!(mcp->spiHandle->Instance->SR & 0x0001))
-        ;
+#ifndef MCP41HVX1_HOST
+    // Never spin in an interrupt (the Wave and Ramp timer paths), where a
+    // retry goes out straight away
+    if (__get_IPSR () != 0)
+    {
+        return;
+    }
 
-    // Store the first 8 bits
-    buffer[0] = *(volatile uint8_t *)(&(mcp->spiHandle->Instance->DR));
+    // Busy wait on the cycle counter, enabling it if nothing has yet
+    if (!(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk))
+    {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
 
-    // Wait until the receive buffer RXNE flag
-    while (!(mcp->spiHandle->Instance->SR & 0x0001))
+    uint32_t start = DWT->CYCCNT;
+    uint32_t cycles = us * (SystemCoreClock / 1000000);
+    while (DWT->CYCCNT - start < cycles)
         ;
+#else
+    (void)us;
+#endif
+}
+
+static HAL_StatusTypeDef
+_mcp_resync (MCP41HVX1 *mcp)
+{
+    HAL_StatusTypeDef status = __MCP_ACQUIRE (mcp);
+    if (status != HAL_OK)
+    {
+        return status;
+    }
+
+    // Raising chip select aborts whatever the device was in the middle of
+    __MCP_XPORT_SELECT (mcp);
+    __MCP_XPORT_UNSELECT (mcp);
+    __MCP_RELEASE (mcp);
+
+    mcp->errors.resyncs++;
+    return HAL_OK;
+}
+
+static HAL_StatusTypeDef
+_mcp_reinit (MCP41HVX1 *mcp)
+{
+    // Reconnect the terminals by writing 0xFF to TCON (0x04)
+    uint8_t tx[2] = { MCP_CMD_WRITE_TCON, 0xFF };
+    uint8_t rx[2] = { 0x00, 0x00 };
+    HAL_StatusTypeDef status = _mcp_command (mcp, tx, rx, 2);
+    if (status != HAL_OK)
+    {
+        return status;
+    }
 
-    // Store the second 8 bits
-    buffer[1] = *(volatile uint8_t *)(&(mcp->spiHandle->Instance->DR));
+    return (rx[0] & 0x02) ? HAL_OK : HAL_ERROR;
+}
+
+/**
+ *  HAL_StatusTypeDef _mcp_command_checked(MCP41HVX1 *mcp, const uint8_t *tx, uint8_t *rx,
+ *                                         uint16_t len)
+ *
+ *  Issue an idempotent command with _mcp_command and check CMDERR in the
+ *  response to its command byte, recovering from it as the device's
+ *  recovery policy says.
+ *
+ *  Returns HAL_OK once the command is acknowledged, HAL_ERROR if it never
+ *  was, or the transport's status if the bus failed.
+ */
+static HAL_StatusTypeDef
+_mcp_command_checked (MCP41HVX1 *mcp, const uint8_t *tx, uint8_t *rx, uint16_t len)
+{
+    const MCP41HVX1_Recovery *policy = mcp->recovery;
+    uint16_t attempts = policy ? (uint16_t)(policy->retries + 1) : 1;
+    uint32_t backoff = policy ? policy->backoffUs : 0;
+    if (backoff > MCP_RECOVERY_BACKOFF_MAX_US)
+        backoff = MCP_RECOVERY_BACKOFF_MAX_US;
+
+    for (uint16_t attempt = 0; attempt < attempts; attempt++)
+    {
+        if (attempt > 0)
+        {
+            mcp->errors.retries++;
+            if (policy->resync)
+                _mcp_resync (mcp);
+
+            _mcp_backoff (backoff);
+            backoff = (backoff > MCP_RECOVERY_BACKOFF_MAX_US / 2) ? MCP_RECOVERY_BACKOFF_MAX_US
+                                                                  : backoff * 2;
+        }
+
+        HAL_StatusTypeDef status = _mcp_command (mcp, tx, rx, len);
+        if (status != HAL_OK)
+        {
+            return status;
+        }
+
+        // If CMDERR (bit 7) is low, then an error has occured
+        if (rx[0] & 0x02)
+        {
+            mcp->errors.consecutive = 0;
+            return HAL_OK;
+        }
+
+        mcp->errors.cmderr++;
+    }
+
+    mcp->errors.failures++;
+    if (mcp->errors.consecutive < UINT8_MAX)
+        mcp->errors.consecutive++;
+
+    // A device failing over and over may have been reset or be stuck, put
+    // it back into a known state and give the command one last chance
+    if (policy && policy->escalateAfter && mcp->errors.consecutive >= policy->escalateAfter)
+    {
+        mcp->errors.reinits++;
+        mcp->errors.consecutive = 0;
+
+        HAL_StatusTypeDef status = policy->reinit ? policy->reinit (mcp) : _mcp_reinit (mcp);
+        if (status == HAL_OK)
+            status = _mcp_command (mcp, tx, rx, len);
+
+        if (status == HAL_OK && (rx[0] & 0x02))
+            return HAL_OK;
+    }
+
+    return HAL_ERROR;
 }
 
 HAL_StatusTypeDef
@@ -130,12 +450,111 @@ MCP41HVX1_Init (MCP41HVX1 *MCP41HVX1,
     MCP41HVX1->spiHandle = spiHandle;
     MCP41HVX1->csPort = csPort;
     MCP41HVX1->csPin = csPin;
+    MCP41HVX1->variant = NULL;
+    MCP41HVX1->maxSckHz = MCP_SCK_MAX_HZ;
+    MCP41HVX1->recovery = NULL;
+    MCP41HVX1->errors = (MCP41HVX1_Errors){ 0 };
+    MCP41HVX1->wait = NULL;
+    MCP41HVX1->transport = &MCP41HVX1_Reg_Transport;
+    MCP41HVX1->bus = spiHandle;
 
-    // TODO(Ethan): Other startup stuff?
+    // NOTE(Ethan): Nothing is sent to the device here, MCP41HVX1_Boot
+    // (MCP41HVX1_Boot.c) brings every device up in one pass.
 
     return HAL_OK;
 }
 
+/**
+ *  HAL_StatusTypeDef MCP41HVX1_Init_Transport(MCP41HVX1 *mcp, const MCP41HVX1_Transport *transport,
+ *                                             void *bus, GPIO_TypeDef *csPort, uint16_t csPin)
+ *
+ *  Initialize a device reached through any transport. bus is the
+ *  transport's own bus context (see MCP41HVX1_Transport.h), devices
+ *  sharing a bus must be given the same one.
+ *
+ *  Returns a HAL_StatusTypeDef indicating success or failure.
+ */
+HAL_StatusTypeDef
+MCP41HVX1_Init_Transport (MCP41HVX1 *mcp,
+                          const MCP41HVX1_Transport *transport,
+                          void *bus,
+                          GPIO_TypeDef *csPort,
+                          uint16_t csPin)
+{
+    if (transport == NULL || bus == NULL)
+    {
+        return HAL_ERROR;
+    }
+
+    // Both on-chip SPI transports reach the peripheral through spiHandle,
+    // the register transport's bus context is the SPI_HandleTypeDef itself
+    mcp->spiHandle = NULL;
+    if (transport == &MCP41HVX1_Reg_Transport)
+        mcp->spiHandle = (SPI_HandleTypeDef *)bus;
+#ifndef MCP41HVX1_HOST
+    if (transport == &MCP41HVX1_HAL_Transport)
+        mcp->spiHandle = ((MCP41HVX1_HAL_Bus *)bus)->spiHandle;
+#endif
+    mcp->csPort = csPort;
+    mcp->csPin = csPin;
+    mcp->variant = NULL;
+    mcp->maxSckHz = MCP_SCK_MAX_HZ;
+    mcp->recovery = NULL;
+    mcp->errors = (MCP41HVX1_Errors){ 0 };
+    mcp->wait = NULL;
+    mcp->transport = transport;
+    mcp->bus = bus;
+
+    return HAL_OK;
+}
+
+/**
+ *  void MCP41HVX1_Wait_Init(MCP41HVX1_Wait *wait, uint8_t strategy, IRQn_Type irq,
+ *                           void (*yield)(void), uint16_t minBytes)
+ *
+ *  Set up a wait strategy for the register transport, to be pointed at by
+ *  the wait field of any number of devices. irq is the SPI interrupt for
+ *  MCP_WAIT_EVENT and yield the hook for MCP_WAIT_YIELD, either is ignored
+ *  by the other strategies.
+ */
+void
+MCP41HVX1_Wait_Init (MCP41HVX1_Wait *wait,
+                     uint8_t strategy,
+                     IRQn_Type irq,
+                     void (*yield) (void),
+                     uint16_t minBytes)
+{
+    wait->strategy = strategy;
+    wait->irq = irq;
+    wait->yield = yield;
+    wait->minBytes = minBytes;
+    wait->waits = 0;
+    wait->sleeps = 0;
+    wait->cycles = 0;
+    wait->maxCycles = 0;
+
+#ifndef MCP41HVX1_HOST
+    // Waits are timed with the cycle counter
+    if (!(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk))
+    {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+
+    // Let interrupts pending while disabled wake the core from WFE
+    if (strategy == MCP_WAIT_EVENT)
+        SCB->SCR |= SCB_SCR_SEVONPEND_Msk;
+#endif
+}
+
+HAL_StatusTypeDef
+MCP41HVX1_Transfer (MCP41HVX1 *mcp, const uint8_t *tx, uint8_t *rx, uint16_t len)
+{
+    return _mcp_command (mcp, tx, rx, len);
+}
+
+#ifndef MCP41HVX1_NO_FLOAT
 float
 MCP41HVX1_To_Resistance (uint8_t code)
 {
@@ -147,135 +566,366 @@ MCP41HVX1_To_Code (float resistance)
 {
     return MCP_FSV - (uint8_t)roundf ((float)resistance / MCP_STEP_RESISTANCE);
 }
+#endif
+
+uint32_t
+MCP41HVX1_To_Milliohms (uint8_t code)
+{
+    return MCP_R_FS * 1000 + (uint32_t)(MCP_FSV - code) * MCP_STEP_RESISTANCE_MOHM;
+}
+
+/**
+ *  uint8_t MCP41HVX1_To_Code_Milliohms(uint32_t milliohms)
+ *
+ *  Integer only equivalent of MCP41HVX1_To_Code. The step count is rounded
+ *  half away from zero like roundf(), the only differences being within a
+ *  float rounding error of a half step, where the float path may land on
+ *  either side, and resistances past MCP_R_MAX, which saturate to code 0.
+ *
+ *  Returns the resistance code.
+ */
+uint8_t
+MCP41HVX1_To_Code_Milliohms (uint32_t milliohms)
+{
+    uint32_t steps = (milliohms + MCP_STEP_RESISTANCE_MOHM / 2) / MCP_STEP_RESISTANCE_MOHM;
+    return (steps >= MCP_FSV) ? 0 : (uint8_t)(MCP_FSV - steps);
+}
 
 HAL_StatusTypeDef
 MCP41HVX1_Move_Wiper (MCP41HVX1 *mcp, MCP41HVX1_Wiper_Command cmd)
 {
-    __HAL_LOCK (mcp->spiHandle);
-    _spi_change_settings (mcp);
-    __MCP_SELECT (mcp);
+    // Send the specified command and store the 8 bit value received
+    uint8_t tx = (uint8_t)cmd;
+    uint8_t rx = 0x00;
+    return _mcp_command_checked (mcp, &tx, &rx, 1);
+}
 
-    // Set the RXNE event to fire when Rx buffer is 1/4 full (8 bits)
-    mcp->spiHandle->Instance->CR2 |= 0x1000;
+/**
+ *  HAL_StatusTypeDef MCP41HVX1_Move_Wiper_N(MCP41HVX1 *mcp, MCP41HVX1_Wiper_Command cmd,
+ *                                           uint8_t count)
+ *
+ *  Send count increment or decrement commands back to back within a
+ *  single chip select frame, moving the wiper count steps for the
+ *  setup/teardown cost of one command.
+ *
+ *  Returns a HAL_StatusTypeDef indicating success or failure.
+ */
+HAL_StatusTypeDef
+MCP41HVX1_Move_Wiper_N (MCP41HVX1 *mcp, MCP41HVX1_Wiper_Command cmd, uint8_t count)
+{
+    if (count == 0)
+    {
+        return HAL_OK;
+    }
 
-    // Enable SPI by setting SPE bit (bit 6)
-    mcp->spiHandle->Instance->CR1 |= 0x0040;
+    HAL_StatusTypeDef status = __MCP_ACQUIRE (mcp);
+    if (status != HAL_OK)
+    {
+        return status;
+    }
 
-    // Wait until the SPI transmit buffer is empty
-    while (!(mcp->spiHandle->Instance->SR & 0x0002))
-        ;
+    __MCP_XPORT_SELECT (mcp);
 
-    // Send the specified command to the SPI data register
-    *((volatile uint8_t *)(&(mcp->spiHandle->Instance->DR))) = (uint8_t)cmd;
+    // Once CMDERR is raised the device answers zeros for the rest of the
+    // frame, so the response to the last command tells whether any of
+    // them failed. Every response lands in rx and only the last is kept.
+    uint8_t tx = (uint8_t)cmd;
+    uint8_t rx = 0x00;
+    for (uint8_t i = 0; i < count && status == HAL_OK; i++)
+        status = __MCP_TRANSFER (mcp, &tx, &rx, 1);
 
-    // Store the 8 bit value received by MCP on command
-    uint8_t rx;
-    _spi_8bit_read (mcp, &rx);
+    __MCP_XPORT_UNSELECT (mcp);
+    __MCP_RELEASE (mcp);
 
-    _spi_disable (mcp->spiHandle);
+    if (status != HAL_OK)
+        return status;
 
-    __MCP_UNSELECT (mcp);
-    _spi_revert_settings (mcp);
-    __HAL_UNLOCK (mcp->spiHandle);
+    // How many steps went through before an error is unknown, so the burst
+    // is never retried and the error only counted
+    if (~rx & 0x02)
+    {
+        mcp->errors.cmderr++;
+        return HAL_ERROR;
+    }
 
-    // If CMDERR (bit 7) is low, then an error has occured
-    uint16_t cmderr = (~rx & 0x02);
-    return (!cmderr) ? HAL_OK : HAL_ERROR;
+    return HAL_OK;
 }
 
 HAL_StatusTypeDef
 MCP41HVX1_Set_Resistance_Code (MCP41HVX1 *mcp, uint8_t code)
 {
-    __HAL_LOCK (mcp->spiHandle);
-    _spi_change_settings (mcp);
-    __MCP_SELECT (mcp);
+    // Set the wiper resistance by writing the resistance code to 0x00
+    uint8_t tx[2] = { 0x00, __MCP_CLAMP_CODE (mcp, code) };
+    uint8_t rx[2] = { 0x00, 0x00 };
+    return _mcp_command_checked (mcp, tx, rx, 2);
+}
 
-    // Set the RXNE event to fire when Rx buffer is 1/4 full (8 bits)
-    mcp->spiHandle->Instance->CR2 |= 0x1000;
+/**
+ *  HAL_StatusTypeDef MCP41HVX1_Set_Resistance_Code_Verified(MCP41HVX1 *mcp, uint8_t code,
+ *                                                           uint8_t retries)
+ *
+ *  Write a resistance code and read it back within the same chip select
+ *  frame, the write and read commands going out back to back. On a
+ *  mismatch or CMDERR the write is tried again up to retries more times.
+ *
+ *  Returns HAL_OK once the code read back matches, HAL_ERROR if it never
+ *  did, or the transport's status if the bus failed.
+ */
+HAL_StatusTypeDef
+MCP41HVX1_Set_Resistance_Code_Verified (MCP41HVX1 *mcp, uint8_t code, uint8_t retries)
+{
+    code = __MCP_CLAMP_CODE (mcp, code);
 
-    // Enable SPI by setting SPE bit (bit 6)
-    mcp->spiHandle->Instance->CR1 |= 0x0040;
+    // Write data to the wiper (0x00), then read data from it (0x0C) with
+    // dummy clocks for the code to come back on
+    const uint8_t tx[4] = { 0x00, code, 0x0C, 0x00 };
 
-    // Set the wiper resistance by writing the resistance code to 0x00
-    _spi_16bit_write (mcp, 0x0000 | code);
+    // NOTE(Ethan): Every attempt is its own bus burst rather than being
+    // retried within one, as a transport may hold back the responses until
+    // the bus is released. Attempts only repeat on a failure, so a verified
+    // write normally costs one setup and one frame of four bytes.
+    for (uint8_t attempt = 0; attempt <= retries; attempt++)
+    {
+        uint8_t rx[4] = { 0x00, 0x00, 0x00, 0x00 };
+        HAL_StatusTypeDef status = _mcp_command (mcp, tx, rx, 4);
+        if (status != HAL_OK)
+        {
+            return status;
+        }
+
+        // Both commands acknowledged (CMDERR high) and the code read back
+        // is the one written
+        if ((rx[0] & 0x02) && (rx[2] & 0x02) && rx[3] == code)
+            return HAL_OK;
+
+        if (!(rx[0] & 0x02) || !(rx[2] & 0x02))
+            mcp->errors.cmderr++;
+    }
 
-    // Store the 16-bit response from MCP.
-    uint8_t rx[2];
-    _spi_16bit_read (mcp, rx);
+    return HAL_ERROR;
+}
 
-    _spi_disable (mcp->spiHandle);
+/**
+ *  HAL_StatusTypeDef MCP41HVX1_Set_Resistance_Code_Multi(MCP41HVX1 *const *mcps,
+ *                                                        const uint8_t *codes, uint8_t count)
+ *
+ *  Write a resistance code to each of count devices sharing one bus in a
+ *  single bus burst. The bus is acquired and configured once and each
+ *  device gets its own chip select frame.
+ *
+ *  Returns a HAL_StatusTypeDef indicating success or failure.
+ */
+HAL_StatusTypeDef
+MCP41HVX1_Set_Resistance_Code_Multi (MCP41HVX1 *const *mcps, const uint8_t *codes, uint8_t count)
+{
+    if (count == 0)
+    {
+        return HAL_OK;
+    }
 
-    __MCP_UNSELECT (mcp);
-    _spi_revert_settings (mcp);
-    __HAL_UNLOCK (mcp->spiHandle);
+    for (uint8_t i = 1; i < count; i++)
+    {
+        if (mcps[i]->bus != mcps[0]->bus || mcps[i]->transport != mcps[0]->transport)
+            return HAL_ERROR;
+    }
 
-    // If CMDERR (bit 7) is low, then an error has occured
-    uint8_t cmderr = (~rx[0] & 0x02);
-    return (!cmderr) ? HAL_OK : HAL_ERROR;
+    HAL_StatusTypeDef status = __MCP_ACQUIRE (mcps[0]);
+    if (status != HAL_OK)
+    {
+        return status;
+    }
+
+    // Responses are only looked at once the bus is released, a transport
+    // may hold back the whole burst until then. Only the command byte's
+    // response matters, the data byte's is dropped into a scratch byte.
+    uint8_t response[UINT8_MAX];
+    uint8_t scratch = 0x00;
+    for (uint8_t i = 0; i < count && status == HAL_OK; i++)
+    {
+        uint8_t tx[2] = { 0x00, __MCP_CLAMP_CODE (mcps[i], codes[i]) };
+        response[i] = 0x00;
+
+        // Both response bytes being received means the frame has been
+        // fully clocked out and chip select can be released
+        __MCP_XPORT_SELECT (mcps[i]);
+        status = __MCP_TRANSFER (mcps[i], &tx[0], &response[i], 1);
+        if (status == HAL_OK)
+            status = __MCP_TRANSFER (mcps[i], &tx[1], &scratch, 1);
+        __MCP_XPORT_UNSELECT (mcps[i]);
+    }
+
+    __MCP_RELEASE (mcps[0]);
+
+    if (status != HAL_OK)
+        return status;
+
+    // If CMDERR (bit 7) is low for any device, then an error has occured.
+    // Writes that did go through can't be told apart from ones that will
+    // once retried, so errors are only counted against their device.
+    uint8_t valid = 0x02;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        valid &= response[i];
+        if (~response[i] & 0x02)
+            mcps[i]->errors.cmderr++;
+    }
+
+    return (valid & 0x02) ? HAL_OK : HAL_ERROR;
 }
 
-HAL_StatusTypeDef
-MCP41HVX1_Set_Resistance (MCP41HVX1 *mcp, float resistance)
+// NOTE(Ethan): The device-less conversions above describe the default
+// 8-bit 50k part. The ones below take the device's variant into account
+// through its resistance table: a code's resistance is read from it, and
+// a resistance is matched to the nearest code by a binary search of it,
+// so no conversion divides at runtime. The table conversions of
+// MCP41HVX1_Variant.h are defined here, so the core needs nothing but
+// this file.
+uint32_t
+MCP41HVX1_Variant_To_Milliohms (const MCP41HVX1_Variant *variant, uint8_t code)
 {
-    if (resistance <= 0)
+    return variant->milliohms[(code > variant->fsv) ? variant->fsv : code];
+}
+
+/**
+ *  uint8_t MCP41HVX1_Variant_To_Code(const MCP41HVX1_Variant *variant, uint32_t milliohms)
+ *
+ *  Convert a resistance in milliohms to the nearest code of the variant
+ *  with a binary search of its resistance table, which falls as the code
+ *  rises. At most 8 probes and no division.
+ *
+ *  Returns the resistance code.
+ */
+uint8_t
+MCP41HVX1_Variant_To_Code (const MCP41HVX1_Variant *variant, uint32_t milliohms)
+{
+    const uint32_t *table = variant->milliohms;
+    uint16_t low = 0;
+    uint16_t high = variant->fsv + 1;
+
+    // First code with a resistance not above the request
+    while (low < high)
     {
-        return HAL_ERROR;
+        uint16_t mid = (low + high) / 2;
+        if (table[mid] > milliohms)
+            low = mid + 1;
+        else
+            high = mid;
     }
 
-    uint8_t code = MCP41HVX1_To_Code (resistance);
-    return MCP41HVX1_Set_Resistance_Code (mcp, code);
+    if (low > variant->fsv)
+        return variant->fsv;
+
+    if (low > 0 && table[low - 1] - milliohms < milliohms - table[low])
+        return (uint8_t)(low - 1);
+
+    return (uint8_t)low;
 }
 
-HAL_StatusTypeDef
-MCP41HVX1_Get_Resistance (MCP41HVX1 *mcp, float *resistance)
+static uint8_t
+_mcp_code_for (MCP41HVX1 *mcp, uint32_t milliohms)
 {
-    HAL_StatusTypeDef status = HAL_ERROR;
+    const MCP41HVX1_Variant *variant = __MCP_VARIANT (mcp);
+    if (variant == NULL)
+    {
+        return MCP41HVX1_To_Code_Milliohms (milliohms);
+    }
 
-    __HAL_LOCK (mcp->spiHandle);
-    _spi_change_settings (mcp);
-    __MCP_SELECT (mcp);
+    return MCP41HVX1_Variant_To_Code (variant, milliohms);
+}
 
-    // Set the RXNE event to fire when Rx buffer is 1/4 full (8 bits)
-    mcp->spiHandle->Instance->CR2 |= 0x1000;
+static uint32_t
+_mcp_milliohms_for (MCP41HVX1 *mcp, uint8_t code)
+{
+    const MCP41HVX1_Variant *variant = __MCP_VARIANT (mcp);
+    if (variant == NULL)
+    {
+        return MCP41HVX1_To_Milliohms (code);
+    }
 
-    // Enable SPI by setting SPE bit (bit 6)
-    mcp->spiHandle->Instance->CR1 |= 0x0040;
+    return MCP41HVX1_Variant_To_Milliohms (variant, code);
+}
 
-    // Wait until the SPI transmit buffer is empty
-    while (!(mcp->spiHandle->Instance->SR & 0x0002))
-        ;
+#ifndef MCP41HVX1_NO_FLOAT
+HAL_StatusTypeDef
+MCP41HVX1_Set_Resistance (MCP41HVX1 *mcp, float resistance)
+{
+    if (resistance <= 0)
+    {
+        return HAL_ERROR;
+    }
+
+    const MCP41HVX1_Variant *variant = __MCP_VARIANT (mcp);
+    if (variant == NULL)
+    {
+        return MCP41HVX1_Set_Resistance_Code (mcp, MCP41HVX1_To_Code (resistance));
+    }
 
-    // Send the read data command
-    *((volatile uint8_t *)(&(mcp->spiHandle->Instance->DR))) = (uint8_t)0x0C;
+    float steps = roundf (resistance * 1000.0f * variant->fsv / (float)variant->rab);
+    uint8_t code = (steps >= variant->fsv) ? 0 : (uint8_t)(variant->fsv - (uint8_t)steps);
+    return MCP41HVX1_Set_Resistance_Code (mcp, code);
+}
+#endif
 
-    // Store the first 8 bits returned from the MCP and check for error
-    uint8_t rx;
-    _spi_8bit_read (mcp, &rx);
-    if (!(~rx & 0x02))
+HAL_StatusTypeDef
+MCP41HVX1_Set_Resistance_Milliohms (MCP41HVX1 *mcp, uint32_t milliohms)
+{
+    if (milliohms == 0)
     {
-        // No error, continue with read
+        return HAL_ERROR;
+    }
 
-        // Wait until the SPI transmit buffer is empty
-        while (!(mcp->spiHandle->Instance->SR & 0x0002))
-            ;
+    uint8_t code = _mcp_code_for (mcp, milliohms);
+    return MCP41HVX1_Set_Resistance_Code (mcp, code);
+}
 
-        // Send dummy clocks
-        *((volatile uint8_t *)(&(mcp->spiHandle->Instance->DR))) = 0x00;
+HAL_StatusTypeDef
+MCP41HVX1_Get_Resistance_Code (MCP41HVX1 *mcp, uint8_t *code)
+{
+    // Send the read data command followed by dummy clocks to read
+    // the returned resistance code from the MCP. On an error the MCP
+    // answers zeros to the dummy clocks, which are then ignored.
+    uint8_t tx[2] = { 0x0C, 0x00 };
+    uint8_t rx[2] = { 0x00, 0x00 };
+    HAL_StatusTypeDef status = _mcp_command_checked (mcp, tx, rx, 2);
+    if (status != HAL_OK)
+    {
+        return status;
+    }
 
-        // Read the returned resistance code from the MCP and
-        // convert into a floating point resistance
-        uint8_t resistanceCode;
-        _spi_8bit_read (mcp, &resistanceCode);
-        *resistance = MCP41HVX1_To_Resistance (resistanceCode);
+    *code = rx[1];
+    return HAL_OK;
+}
 
-        status = HAL_OK;
+#ifndef MCP41HVX1_NO_FLOAT
+HAL_StatusTypeDef
+MCP41HVX1_Get_Resistance (MCP41HVX1 *mcp, float *resistance)
+{
+    // Read the resistance code from the MCP and convert
+    // into a floating point resistance
+    uint8_t code;
+    HAL_StatusTypeDef status = MCP41HVX1_Get_Resistance_Code (mcp, &code);
+    if (status != HAL_OK)
+    {
+        return status;
     }
 
-    _spi_disable (mcp->spiHandle);
+    const MCP41HVX1_Variant *variant = __MCP_VARIANT (mcp);
+    if (variant == NULL)
+        *resistance = MCP41HVX1_To_Resistance (code);
+    else
+        *resistance = (float)_mcp_milliohms_for (mcp, code) / 1000.0f;
 
-    __MCP_UNSELECT (mcp);
-    _spi_revert_settings (mcp);
-    __HAL_UNLOCK (mcp->spiHandle);
+    return HAL_OK;
+}
+#endif
+
+HAL_StatusTypeDef
+MCP41HVX1_Get_Resistance_Milliohms (MCP41HVX1 *mcp, uint32_t *milliohms)
+{
+    uint8_t code;
+    HAL_StatusTypeDef status = MCP41HVX1_Get_Resistance_Code (mcp, &code);
+    if (status == HAL_OK)
+        *milliohms = _mcp_milliohms_for (mcp, code);
 
     return status;
 }
@@ -285,65 +935,190 @@ MCP41HVX1_Startup (MCP41HVX1 *mcp)
 {
     // To startup, we need to reconnect the A terminal and the wiper. This
     // is accomplished by writing 0xFF to the TCON register (0x04).
+    uint8_t tx[2] = { MCP_CMD_WRITE_TCON, 0xFF };
+    uint8_t rx[2] = { 0x00, 0x00 };
+    return _mcp_command_checked (mcp, tx, rx, 2);
+}
 
-    __HAL_LOCK (mcp->spiHandle);
-    _spi_change_settings (mcp);
-    __MCP_SELECT (mcp);
-
-    // Set the RXNE event to fire when Rx buffer is 1/4 full (8 bits)
-    mcp->spiHandle->Instance->CR2 |= 0x1000;
+HAL_StatusTypeDef
+MCP41HVX1_Shutdown (MCP41HVX1 *mcp)
+{
+    // To shutdown, we need to disconnect the A terminal and the wiper. This
+    // is accomplished by writing 0xF9 to the TCON register (0x04).
+    uint8_t tx[2] = { MCP_CMD_WRITE_TCON, 0xF9 };
+    uint8_t rx[2] = { 0x00, 0x00 };
+    return _mcp_command_checked (mcp, tx, rx, 2);
+}
 
-    // Enable SPI by setting SPE bit (bit 6)
-    mcp->spiHandle->Instance->CR1 |= 0x0040;
+void
+MCP41HVX1_Stream_Build (const uint8_t *codes, uint32_t count, const uint8_t **chain)
+{
+    // Each code is simply an index into the flash resident frame table
+    for (uint32_t i = 0; i < count; i++)
+        chain[i] = MCP41HVX1_FRAME (codes[i]);
+}
 
-    // Write 0xFF to the TCON register 0x04
-    _spi_16bit_write (mcp, 0x04FF);
+static void
+_stream_kick (MCP41HVX1_Stream *stream)
+{
+    // Point the DMA at the next pre-encoded frame, no encoding required
+    DMA_Stream_TypeDef *dma = stream->mcp->spiHandle->hdmatx->Instance;
+    dma->M0AR = (uint32_t)(uintptr_t)stream->chain[stream->position];
+    dma->NDTR = 2;
+    dma->CR |= 0x0001;
+}
 
-    // Store the 16 bit value received by MCP on command
-    uint8_t rx[2];
-    _spi_16bit_read (mcp, rx);
+static void
+_stream_finish (MCP41HVX1_Stream *stream)
+{
+    MCP41HVX1 *mcp = stream->mcp;
 
+    // Last frame is out, disable the Tx DMA request and the SPI
+    mcp->spiHandle->Instance->CR2 &= ~0x0002;
     _spi_disable (mcp->spiHandle);
 
+    // Responses were never read, so the Rx FIFO has overrun. OVR is
+    // cleared by the DR reads in _spi_disable followed by an SR read.
+    volatile uint32_t tempReg = mcp->spiHandle->Instance->SR;
+    (void)tempReg;
+
     __MCP_UNSELECT (mcp);
-    _spi_revert_settings (mcp);
+    _spi_revert_settings (mcp, stream->spiMode);
     __HAL_UNLOCK (mcp->spiHandle);
 
-    // If CMDERR (bit 7) is low, then an error has occured
-    uint16_t cmderr = (~rx[0] & 0x02);
-    return (!cmderr) ? HAL_OK : HAL_ERROR;
+    stream->busy = 0;
 }
 
+/**
+ *  HAL_StatusTypeDef MCP41HVX1_Stream_Start(MCP41HVX1_Stream *stream, MCP41HVX1 *mcp,
+ *                                           const uint8_t *const *chain, uint32_t length,
+ *                                           uint8_t flags)
+ *
+ *  Start streaming a chain of pre-encoded frames to the device using the
+ *  Tx DMA stream linked to the SPI handle (spiHandle->hdmatx). Chip select is
+ *  held for the whole chain and the SPI bus stays locked until the last frame
+ *  has been sent. The DMA stream interrupt must call MCP41HVX1_Stream_IRQHandler
+ *  instead of HAL_DMA_IRQHandler while a stream is active.
+ *
+ *  With MCP_STREAM_PACED, only the first frame is sent immediately and every
+ *  following frame waits for a call to MCP41HVX1_Stream_Trigger, typically
+ *  from a timer interrupt running at the sample rate. With MCP_STREAM_LOOP,
+ *  the chain restarts from the beginning until MCP41HVX1_Stream_Stop is called.
+ *
+ *  Returns a HAL_StatusTypeDef indicating success or failure.
+ */
 HAL_StatusTypeDef
-MCP41HVX1_Shutdown (MCP41HVX1 *mcp)
+MCP41HVX1_Stream_Start (MCP41HVX1_Stream *stream,
+                        MCP41HVX1 *mcp,
+                        const uint8_t *const *chain,
+                        uint32_t length,
+                        uint8_t flags)
 {
-    // To shutdown, we need to disconnect the A terminal and the wiper. This
-    // is accomplished by writing 0xF9 to the TCON register (0x04).
+    // Streams drive the SPI and DMA registers directly
+    if (length == 0 || mcp->transport != &MCP41HVX1_Reg_Transport
+        || mcp->spiHandle->hdmatx == NULL)
+    {
+        return HAL_ERROR;
+    }
 
     __HAL_LOCK (mcp->spiHandle);
-    _spi_change_settings (mcp);
+
+    stream->mcp = mcp;
+    stream->chain = chain;
+    stream->length = length;
+    stream->position = 0;
+    stream->flags = flags;
+    stream->pending = 0;
+    stream->stopping = 0;
+    stream->busy = 1;
+
+    stream->spiMode = _spi_change_settings (mcp);
     __MCP_SELECT (mcp);
 
     // Set the RXNE event to fire when Rx buffer is 1/4 full (8 bits)
     mcp->spiHandle->Instance->CR2 |= 0x1000;
 
-    // Enable SPI by setting SPE bit (bit 6)
+    DMA_HandleTypeDef *hdma = mcp->spiHandle->hdmatx;
+    DMA_Stream_TypeDef *dma = hdma->Instance;
+
+    // Disable the DMA stream and wait for EN to read back low
+    // before touching its configuration
+    dma->CR &= ~0x0001;
+    while ((dma->CR & 0x0001))
+        ;
+
+    // Normal (non circular, single buffer) memory to peripheral transfers of
+    // bytes, incrementing the memory address, with transfer complete interrupt.
+    // Channel selection and priority are left as configured by HAL_DMA_Init.
+    dma->CR &= ~(0x00040000 | 0x00007800 | 0x00000100 | 0x000000C0 | 0x00000020);
+    dma->CR |= 0x00000400 | 0x00000040 | 0x00000010;
+
+    dma->PAR = (uint32_t)(uintptr_t)&mcp->spiHandle->Instance->DR;
+    dma->M0AR = (uint32_t)(uintptr_t)chain[0];
+    dma->NDTR = 2;
+    __HAL_DMA_CLEAR_FLAG (hdma, __HAL_DMA_GET_TC_FLAG_INDEX (hdma));
+
+    // Enable the DMA stream, then the Tx DMA request (TXDMAEN, bit 1),
+    // then the SPI itself as per Section 32.5.8 of Reference Manual 0385
+    dma->CR |= 0x0001;
+    mcp->spiHandle->Instance->CR2 |= 0x0002;
     mcp->spiHandle->Instance->CR1 |= 0x0040;
 
-    // Write 0xF9 to the TCON register 0x04.
-    _spi_16bit_write (mcp, 0x04F9);
+    return HAL_OK;
+}
+
+void
+MCP41HVX1_Stream_IRQHandler (MCP41HVX1_Stream *stream)
+{
+    DMA_HandleTypeDef *hdma = stream->mcp->spiHandle->hdmatx;
 
-    // Store the 16 bit value received by MCP on command
-    uint8_t rx[2];
-    _spi_16bit_read (mcp, rx);
+    if (!stream->busy || !__HAL_DMA_GET_FLAG (hdma, __HAL_DMA_GET_TC_FLAG_INDEX (hdma)))
+        return;
 
-    _spi_disable (mcp->spiHandle);
+    __HAL_DMA_CLEAR_FLAG (hdma, __HAL_DMA_GET_TC_FLAG_INDEX (hdma));
 
-    __MCP_UNSELECT (mcp);
-    _spi_revert_settings (mcp);
-    __HAL_UNLOCK (mcp->spiHandle);
+    uint32_t next = stream->position + 1;
+    if (next >= stream->length)
+    {
+        if (!(stream->flags & MCP_STREAM_LOOP) || stream->stopping)
+        {
+            _stream_finish (stream);
+            return;
+        }
 
-    // If CMDERR (bit 7) is low, then an error has occured
-    uint16_t cmderr = (~rx[0] & 0x02);
-    return (!cmderr) ? HAL_OK : HAL_ERROR;
+        next = 0;
+    }
+
+    stream->position = next;
+
+    // Paced streams wait for the next trigger before sending
+    if (stream->flags & MCP_STREAM_PACED)
+        stream->pending = 1;
+    else if (stream->stopping)
+        _stream_finish (stream);
+    else
+        _stream_kick (stream);
+}
+
+void
+MCP41HVX1_Stream_Trigger (MCP41HVX1_Stream *stream)
+{
+    // Must run at the same interrupt priority as the DMA stream interrupt
+    if (!stream->busy || !stream->pending)
+        return;
+
+    stream->pending = 0;
+
+    if (stream->stopping)
+        _stream_finish (stream);
+    else
+        _stream_kick (stream);
+}
+
+void
+MCP41HVX1_Stream_Stop (MCP41HVX1_Stream *stream)
+{
+    // The stream finishes cleanly on a frame boundary, either at the
+    // next transfer complete interrupt or the next trigger
+    stream->stopping = 1;
 }
@@ -7,7 +7,11 @@
 #ifndef MCP41HVX1_SPI_DRIVER_H
 #define MCP41HVX1_SPI_DRIVER_H
 
+#ifndef MCP41HVX1_HOST
 #include "stm32f7xx_hal.h" /* Needed for structure defs */
+#else
+#include "MCP41HVX1_Host.h" /* Host stand-ins for the structure defs */
+#endif
 
 // NOTE(Ethan): This step resistance is calculated from
 // the following formula:
@@ -19,11 +23,24 @@
 //  Rfs = Rzs = 0 ohms. This might be really bad and we
 //  may need to actually measure these values!
 #define MCP_STEP_RESISTANCE 196.08f
+#define MCP_STEP_RESISTANCE_MOHM 196080
 #define MCP_FSV 255
 #define MCP_R_FS 0
 #define MCP_R_ZS 0
 #define MCP_R_MAX 50000
 
+// Fastest SCK frequency the MCP41HVX1 supports
+#define MCP_SCK_MAX_HZ 10000000
+
+// Command byte writing the TCON register. The register address (0x04)
+// sits in the upper nibble and the command in bits 3:2, a bare 0x04
+// would instead increment the wiper.
+#define MCP_CMD_WRITE_TCON 0x40
+
+// NOTE(Ethan): Defining MCP41HVX1_NO_FLOAT compiles out every API taking
+// or returning a float resistance, leaving only the integer milliohm API
+// (and MCP41HVX1_Batch out entirely), for projects that cannot use the FPU.
+
 /* MCP41HVX1 SPI Wiper Command Bytes */
 typedef enum
 {
@@ -31,6 +48,34 @@ typedef enum
     DECR_WIPER = 0x08,
 } MCP41HVX1_Wiper_Command;
 
+/* MCP41HVX1 Device Variant Struct, see MCP41HVX1_Variant.h */
+typedef struct
+{
+    // Full scale code, 127 for the 7-bit MCP41HV31, 255 for the 8-bit MCP41HV51
+    uint8_t fsv;
+
+    // Terminal to terminal resistance (Rab) in milliohms
+    uint32_t rab;
+
+    // Terminal A to wiper resistance of every code in milliohms, fsv + 1 entries
+    const uint32_t *milliohms;
+} MCP41HVX1_Variant;
+
+/* MCP41HVX1 Error Counters Struct */
+typedef struct
+{
+    // Commands answered with CMDERR, retries made, chip select resyncs,
+    // re-initializations and commands that failed despite all of them
+    uint32_t cmderr;
+    uint32_t retries;
+    uint32_t resyncs;
+    uint32_t reinits;
+    uint32_t failures;
+
+    // Commands failed in a row, reset by any command succeeding
+    uint8_t consecutive;
+} MCP41HVX1_Errors;
+
 /* MCP41HVX1 Sensor Struct */
 typedef struct
 {
@@ -42,19 +87,236 @@ typedef struct
 
     // 16 bit pin number of the chip select GPIO pin (active low)
     unsigned short csPin;
+
+    // Part fitted for this device, NULL for the default 8-bit 50k part
+    // described by MCP_FSV and MCP_R_MAX
+    const MCP41HVX1_Variant *variant;
+
+    // Fastest SCK frequency to run the device at. The SPI baud rate is
+    // raised or lowered to the fastest prescaler within it for every
+    // command and restored afterwards, 0 keeps the handle's own.
+    uint32_t maxSckHz;
+
+    // SPI CR1 polarity, phase and baud rate bits the bus had before the
+    // device acquired it, restored on release. Kept per device so devices
+    // on different buses don't restore each other's settings.
+    uint32_t spiMode;
+
+    // Transport used to reach the device and its bus context, see
+    // MCP41HVX1_Transport.h. For the register transport set up by
+    // MCP41HVX1_Init the bus context is the SPI handle.
+    const struct MCP41HVX1_Transport *transport;
+    void *bus;
+
+    // How CMDERR is recovered from, NULL to report it straight away, and
+    // what went wrong so far
+    const struct MCP41HVX1_Recovery *recovery;
+    MCP41HVX1_Errors errors;
+
+    // How the register transport waits on the SPI status flags, NULL to spin
+    struct MCP41HVX1_Wait *wait;
 } MCP41HVX1;
 
+// Variant a device is fitted with, NULL for the default part, and its full
+// scale code. Every conversion and clamp taking a device goes through
+// these, so defining MCP41HVX1_FIXED_VARIANT (see MCP41HVX1_Variant.h)
+// binds the whole driver to one part.
+#ifdef MCP41HVX1_FIXED_VARIANT
+extern const MCP41HVX1_Variant MCP41HVX1_FIXED_VARIANT;
+#define __MCP_VARIANT(__MCP__) ((void)(__MCP__), &MCP41HVX1_FIXED_VARIANT)
+#define __MCP_FSV(__MCP__) ((void)(__MCP__), MCP41HVX1_FIXED_VARIANT.fsv)
+#else
+#define __MCP_VARIANT(__MCP__) ((__MCP__)->variant)
+#define __MCP_FSV(__MCP__) ((__MCP__)->variant ? (__MCP__)->variant->fsv : MCP_FSV)
+#endif
+
+// Codes past the full scale value of the fitted part are clamped to it
+#define __MCP_CLAMP_CODE(__MCP__, __CODE__)                                                        \
+    (((__CODE__) > __MCP_FSV (__MCP__)) ? __MCP_FSV (__MCP__) : (__CODE__))
+
+// NOTE(Ethan): CMDERR means the device didn't take a command, typically a
+// glitch on a noisy harness knocking it out of step. The device ignores
+// everything until chip select is raised, so an idempotent command (write,
+// read, TCON write, single increment/decrement) can just be sent again.
+// A recovery policy retries such commands in place, optionally raising
+// chip select in an empty frame first and backing off between attempts,
+// and re-initializes a device that keeps failing. Bursts of several
+// commands (Move_Wiper_N, Set_Resistance_Code_Multi) are counted but never
+// retried, as how far they got is unknown.
+//
+//  The backoff is a busy wait, meant for commands issued from threads or
+//  the main loop. Commands issued from an interrupt, such as the Wave and
+//  Ramp timer paths, are still retried but never back off, so a policy
+//  shared with them should rely on resync rather than on the backoff.
+
+// Longest wait between two attempts in microseconds, the backoff stops
+// doubling once it gets there
+#define MCP_RECOVERY_BACKOFF_MAX_US 10000
+
+/* MCP41HVX1 Error Recovery Policy Struct */
+typedef struct MCP41HVX1_Recovery
+{
+    // Further attempts at a command answered with CMDERR
+    uint8_t retries;
+
+    // Wait before the first retry in microseconds, doubled for every further
+    // one up to MCP_RECOVERY_BACKOFF_MAX_US
+    uint32_t backoffUs;
+
+    // Raise chip select in an empty frame before every retry
+    uint8_t resync;
+
+    // Failed commands in a row after which the device is re-initialized and
+    // the command tried once more, 0 to never re-initialize
+    uint8_t escalateAfter;
+
+    // Re-initializes the device, restoring whatever state the application
+    // keeps. NULL reconnects the terminals by writing TCON (0xFF).
+    HAL_StatusTypeDef (*reinit) (MCP41HVX1 *mcp);
+} MCP41HVX1_Recovery;
+
+// NOTE(Ethan): The register transport waits on the SPI status flags for
+// every byte it exchanges. Spinning is the quickest way through a short
+// command at full SCK, but a long burst or a slow SCK keeps the core busy
+// for the whole transfer. A device can be given another wait strategy:
+//
+//      MCP_WAIT_SPIN   poll the status register
+//      MCP_WAIT_EVENT  sleep in WFE until the flag's SPI interrupt pends.
+//                      The interrupt must stay disabled in the NVIC: with
+//                      SEVONPEND set (by MCP41HVX1_Wait_Init) the pending
+//                      interrupt alone wakes the core.
+//      MCP_WAIT_YIELD  call a yield hook between polls (e.g. taskYIELD)
+//
+//  Which one a call uses depends on its length: transfers shorter than
+//  minBytes spin whatever the strategy. Every wait is timed with the DWT
+//  cycle counter, and the difference between a strategy's average wait
+//  and that of MCP_WAIT_SPIN for the same traffic is its wake latency.
+
+/* MCP41HVX1 Wait Strategies */
+#define MCP_WAIT_SPIN 0
+#define MCP_WAIT_EVENT 1
+#define MCP_WAIT_YIELD 2
+
+/* MCP41HVX1 Wait Strategy Struct */
+typedef struct MCP41HVX1_Wait
+{
+    uint8_t strategy;
+
+    // SPI interrupt pended by the flags for MCP_WAIT_EVENT, and the hook
+    // called for MCP_WAIT_YIELD
+    IRQn_Type irq;
+    void (*yield) (void);
+
+    // Shortest transfer the strategy is used for, in bytes
+    uint16_t minBytes;
+
+    // Waits made, times the core slept or yielded during them, and the
+    // total and longest time waited in cycles (counted on target only)
+    uint32_t waits;
+    uint32_t sleeps;
+    uint32_t cycles;
+    uint32_t maxCycles;
+} MCP41HVX1_Wait;
+
+// Pre-encoded wiper write frames (command byte, data byte) for every
+// code, generated at compile time and resident in flash. Frames can be
+// referenced directly by a DMA stream so no encoding happens at runtime.
+extern const uint8_t MCP41HVX1_Frame_Table[MCP_FSV + 1][2];
+
+// Address of the pre-encoded frame for a given code. This is an address
+// constant, so chains built from it can themselves be const and live in flash.
+#define MCP41HVX1_FRAME(__CODE__) (MCP41HVX1_Frame_Table[(uint8_t)(__CODE__)])
+
+/* MCP41HVX1 DMA Frame Stream Flags */
+#define MCP_STREAM_LOOP 0x01
+#define MCP_STREAM_PACED 0x02
+
+/* MCP41HVX1 DMA Frame Stream Struct */
+typedef struct
+{
+    // Device the stream is being played to
+    MCP41HVX1 *mcp;
+
+    // Chain of frames to send, each entry points into MCP41HVX1_Frame_Table
+    const uint8_t *const *chain;
+
+    // Number of frames in the chain
+    uint32_t length;
+
+    // Index of the frame currently being transferred by the DMA
+    volatile uint32_t position;
+
+    // MCP_STREAM_* flags the stream was started with
+    uint8_t flags;
+
+    // Set while a paced stream waits for MCP41HVX1_Stream_Trigger
+    volatile uint8_t pending;
+
+    // Set by MCP41HVX1_Stream_Stop, the stream ends on the next frame boundary
+    volatile uint8_t stopping;
+
+    // Set while the stream owns the SPI bus
+    volatile uint8_t busy;
+
+    // SPI CR1 polarity, phase and baud rate bits to restore once the
+    // stream ends
+    uint32_t spiMode;
+} MCP41HVX1_Stream;
+
 HAL_StatusTypeDef MCP41HVX1_Init (MCP41HVX1 *MCP41HVX1,
                                   SPI_HandleTypeDef *spiHandle,
                                   GPIO_TypeDef *csPort,
                                   unsigned short csPin);
+HAL_StatusTypeDef MCP41HVX1_Init_Transport (MCP41HVX1 *mcp,
+                                            const struct MCP41HVX1_Transport *transport,
+                                            void *bus,
+                                            GPIO_TypeDef *csPort,
+                                            uint16_t csPin);
+void MCP41HVX1_Wait_Init (MCP41HVX1_Wait *wait,
+                          uint8_t strategy,
+                          IRQn_Type irq,
+                          void (*yield) (void),
+                          uint16_t minBytes);
+HAL_StatusTypeDef MCP41HVX1_Transfer (MCP41HVX1 *mcp,
+                                      const uint8_t *tx,
+                                      uint8_t *rx,
+                                      uint16_t len);
+#ifndef MCP41HVX1_NO_FLOAT
 float MCP41HVX1_To_Resistance (uint8_t code);
 uint8_t MCP41HVX1_To_Code (float resistance);
+#endif
+uint32_t MCP41HVX1_To_Milliohms (uint8_t code);
+uint8_t MCP41HVX1_To_Code_Milliohms (uint32_t milliohms);
 HAL_StatusTypeDef MCP41HVX1_Move_Wiper (MCP41HVX1 *mcp, MCP41HVX1_Wiper_Command cmd);
+HAL_StatusTypeDef MCP41HVX1_Move_Wiper_N (MCP41HVX1 *mcp,
+                                          MCP41HVX1_Wiper_Command cmd,
+                                          uint8_t count);
+#ifndef MCP41HVX1_NO_FLOAT
 HAL_StatusTypeDef MCP41HVX1_Set_Resistance (MCP41HVX1 *mcp, float resistance);
+#endif
+HAL_StatusTypeDef MCP41HVX1_Set_Resistance_Milliohms (MCP41HVX1 *mcp, uint32_t milliohms);
 HAL_StatusTypeDef MCP41HVX1_Set_Resistance_Code (MCP41HVX1 *mcp, uint8_t code);
+HAL_StatusTypeDef MCP41HVX1_Set_Resistance_Code_Verified (MCP41HVX1 *mcp,
+                                                          uint8_t code,
+                                                          uint8_t retries);
+HAL_StatusTypeDef MCP41HVX1_Set_Resistance_Code_Multi (MCP41HVX1 *const *mcps,
+                                                       const uint8_t *codes,
+                                                       uint8_t count);
+HAL_StatusTypeDef MCP41HVX1_Get_Resistance_Code (MCP41HVX1 *mcp, uint8_t *code);
+#ifndef MCP41HVX1_NO_FLOAT
 HAL_StatusTypeDef MCP41HVX1_Get_Resistance (MCP41HVX1 *mcp, float *resistance);
+#endif
+HAL_StatusTypeDef MCP41HVX1_Get_Resistance_Milliohms (MCP41HVX1 *mcp, uint32_t *milliohms);
 HAL_StatusTypeDef MCP41HVX1_Startup (MCP41HVX1 *mcp);
 HAL_StatusTypeDef MCP41HVX1_Shutdown (MCP41HVX1 *mcp);
+void MCP41HVX1_Stream_Build (const uint8_t *codes, uint32_t count, const uint8_t **chain);
+HAL_StatusTypeDef MCP41HVX1_Stream_Start (MCP41HVX1_Stream *stream,
+                                          MCP41HVX1 *mcp,
+                                          const uint8_t *const *chain,
+                                          uint32_t length,
+                                          uint8_t flags);
+void MCP41HVX1_Stream_IRQHandler (MCP41HVX1_Stream *stream);
+void MCP41HVX1_Stream_Trigger (MCP41HVX1_Stream *stream);
+void MCP41HVX1_Stream_Stop (MCP41HVX1_Stream *stream);
 
 #endif
@@ -0,0 +1,144 @@
+/**
+ *      MCP41HVX1 STM32F7 SPI Driver - C++ Compile Time Conversions
+ *
+ *      Author:     Ethan Garnier
+ *      Date:       2025
+ */
+#ifndef MCP41HVX1_SPI_DRIVER_HPP
+#define MCP41HVX1_SPI_DRIVER_HPP
+
+// NOTE(Ethan): C++ projects should include this header (or wrap any of the
+// C headers in extern "C" themselves). Everything below is constexpr, needs
+// C++11 or later, and mirrors the C conversion functions exactly so tables
+// of constant setpoints fold to codes at compile time:
+//
+//      static constexpr uint8_t codes[] = { mcp41hvx1::to_code (1000.0f),
+//                                           mcp41hvx1::code_for<2500000>::value };
+//
+//  A setpoint outside (0, MCP_R_MAX] in a constant expression is a compile
+//  error. Evaluated at runtime the same functions saturate instead.
+extern "C"
+{
+#include "MCP41HVX1.h"
+}
+
+namespace mcp41hvx1
+{
+
+// Not constexpr on purpose, reaching it in a constant expression is
+// what turns an out of range setpoint into a compile error.
+inline void
+setpoint_out_of_range ()
+{
+}
+
+// roundf() of a non negative value, trunc(x) + (x - trunc(x) >= 0.5) is
+// exact in single precision where x + 0.5f is not
+constexpr long
+round_steps (float steps)
+{
+    return static_cast<long> (steps)
+           + ((steps - static_cast<float> (static_cast<long> (steps))) >= 0.5f ? 1 : 0);
+}
+
+constexpr uint8_t
+saturate_code (long steps)
+{
+    return (steps >= MCP_FSV) ? 0 : static_cast<uint8_t> (MCP_FSV - steps);
+}
+
+/* Equivalent of MCP41HVX1_To_Code */
+constexpr uint8_t
+to_code (float resistance)
+{
+    return (resistance <= 0.0f || resistance > static_cast<float> (MCP_R_MAX))
+               ? (setpoint_out_of_range (), saturate_code (resistance <= 0.0f ? 0 : MCP_FSV))
+               : saturate_code (round_steps (resistance / MCP_STEP_RESISTANCE));
+}
+
+/* Equivalent of MCP41HVX1_To_Resistance */
+constexpr float
+to_resistance (uint8_t code)
+{
+    return MCP_R_FS + static_cast<float> (MCP_FSV - code) * MCP_STEP_RESISTANCE;
+}
+
+/* Equivalent of MCP41HVX1_To_Code_Milliohms */
+constexpr uint8_t
+to_code_milliohms (unsigned long milliohms)
+{
+    return (milliohms == 0 || milliohms > MCP_R_MAX * 1000UL)
+               ? (setpoint_out_of_range (), saturate_code (milliohms == 0 ? 0 : MCP_FSV))
+               : saturate_code (static_cast<long> (
+                   (milliohms + MCP_STEP_RESISTANCE_MOHM / 2) / MCP_STEP_RESISTANCE_MOHM));
+}
+
+/* Equivalent of MCP41HVX1_To_Milliohms */
+constexpr unsigned long
+to_milliohms (uint8_t code)
+{
+    return MCP_R_FS * 1000UL
+           + static_cast<unsigned long> (MCP_FSV - code) * MCP_STEP_RESISTANCE_MOHM;
+}
+
+// Rounded (half away from zero) signed division
+constexpr long long
+round_div (long long numerator, long long denominator)
+{
+    return ((numerator < 0) != (denominator < 0)) ? (numerator - denominator / 2) / denominator
+                                                  : (numerator + denominator / 2) / denominator;
+}
+
+/* Calibrated resistance of a code, the same interpolation MCP41HVX1_Network
+   uses between the resistances measured at code 0 and code MCP_FSV */
+constexpr unsigned long
+to_milliohms_calibrated (uint8_t code, unsigned long atZero, unsigned long atFull)
+{
+    return static_cast<unsigned long> (
+        static_cast<long long> (atZero)
+        + round_div ((static_cast<long long> (atFull) - static_cast<long long> (atZero)) * code,
+                     MCP_FSV));
+}
+
+constexpr long
+clamp_code (long long code)
+{
+    return (code < 0) ? 0 : (code > MCP_FSV) ? MCP_FSV : static_cast<long> (code);
+}
+
+// Code interpolated between the calibration points, saturating to the end
+// nearest a setpoint beyond either of them
+constexpr uint8_t
+calibrated_code (unsigned long milliohms, unsigned long atZero, unsigned long atFull)
+{
+    return static_cast<uint8_t> (clamp_code (round_div (
+        (static_cast<long long> (milliohms) - static_cast<long long> (atZero)) * MCP_FSV,
+        static_cast<long long> (atFull) - static_cast<long long> (atZero))));
+}
+
+/* Code whose calibrated resistance is closest to the setpoint */
+constexpr uint8_t
+to_code_calibrated (unsigned long milliohms, unsigned long atZero, unsigned long atFull)
+{
+    return (atZero == atFull) ? (setpoint_out_of_range (), static_cast<uint8_t> (0))
+           : (milliohms < (atZero < atFull ? atZero : atFull)
+              || milliohms > (atZero < atFull ? atFull : atZero))
+               ? (setpoint_out_of_range (), calibrated_code (milliohms, atZero, atFull))
+               : calibrated_code (milliohms, atZero, atFull);
+}
+
+/* Code for a setpoint given as a template argument, checked with static_assert */
+template <unsigned long MilliOhms>
+struct code_for
+{
+    static_assert (MilliOhms > 0 && MilliOhms <= MCP_R_MAX * 1000UL,
+                   "MCP41HVX1 setpoint is outside (0, MCP_R_MAX]");
+    static constexpr uint8_t value = to_code_milliohms (MilliOhms);
+};
+
+template <unsigned long MilliOhms>
+constexpr uint8_t code_for<MilliOhms>::value;
+
+}
+
+#endif
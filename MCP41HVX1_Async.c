@@ -0,0 +1,255 @@
+/**
+ *      MCP41HVX1 STM32F7 SPI Driver - Asynchronous API
+ *
+ *      Author:     Ethan Garnier
+ *      Date:       2025
+ */
+#include "MCP41HVX1_Async.h"
+
+#ifdef MCP41HVX1_OS
+// The complete flag is handed over in a critical section, so whoever sees
+// it set also sees the transaction's outcome
+static uint8_t
+_async_complete (MCP41HVX1_Future *future)
+{
+    uint32_t state = MCP41HVX1_Os_Critical_Enter ();
+    uint8_t complete = future->complete;
+    MCP41HVX1_Os_Critical_Exit (state);
+    return complete;
+}
+
+static void
+_async_done (MCP41HVX1_Txn *txn)
+{
+    MCP41HVX1_Future *future = (MCP41HVX1_Future *)txn->context;
+    if (future->callback)
+        future->callback (future);
+
+    uint32_t state = MCP41HVX1_Os_Critical_Enter ();
+    future->complete = 1;
+    MCP41HVX1_Os_Critical_Exit (state);
+
+    MCP41HVX1_Os_Signal_Raise (&future->done);
+}
+
+static void
+_async_worker (void *argument)
+{
+    MCP41HVX1_Async *async = (MCP41HVX1_Async *)argument;
+
+    while (!async->stopping)
+    {
+        // An idle hook is given the idle bus every so often, otherwise
+        // the worker sleeps until something is submitted
+        uint32_t timeout = async->sched.idle ? MCP_ASYNC_IDLE_MS : MCP_OS_FOREVER;
+        MCP41HVX1_Os_Signal_Wait (&async->work, timeout);
+
+        while (!async->stopping && MCP41HVX1_Sched_Run (&async->sched) == HAL_BUSY)
+            MCP41HVX1_Os_Sleep (MCP_ASYNC_BUSY_MS);
+    }
+
+    MCP41HVX1_Os_Signal_Raise (&async->stopped);
+}
+
+/**
+ *  HAL_StatusTypeDef MCP41HVX1_Async_Init(MCP41HVX1_Async *async, MCP41HVX1 *mcp)
+ *
+ *  Set up asynchronous access to the bus mcp is on. Every device whose
+ *  transactions are submitted must share its bus context and transport.
+ *
+ *  Returns a HAL_StatusTypeDef indicating success or failure.
+ */
+HAL_StatusTypeDef
+MCP41HVX1_Async_Init (MCP41HVX1_Async *async, MCP41HVX1 *mcp)
+{
+    HAL_StatusTypeDef status = MCP41HVX1_Sched_Init (&async->sched, mcp);
+    if (status != HAL_OK)
+    {
+        return status;
+    }
+
+    MCP41HVX1_Os_Signal_Init (&async->work);
+    MCP41HVX1_Os_Signal_Init (&async->stopped);
+    async->stopping = 0;
+
+    return HAL_OK;
+}
+
+/**
+ *  HAL_StatusTypeDef MCP41HVX1_Async_Start(MCP41HVX1_Async *async, uint32_t priority,
+ *                                          uint32_t stackBytes)
+ *
+ *  Start the bus' worker thread. From then on the bus must only be used
+ *  through the asynchronous API.
+ *
+ *  Returns a HAL_StatusTypeDef indicating success or failure.
+ */
+HAL_StatusTypeDef
+MCP41HVX1_Async_Start (MCP41HVX1_Async *async, uint32_t priority, uint32_t stackBytes)
+{
+    async->stopping = 0;
+    return MCP41HVX1_Os_Thread_Start (_async_worker, async, priority, stackBytes);
+}
+
+/**
+ *  void MCP41HVX1_Async_Stop(MCP41HVX1_Async *async)
+ *
+ *  Stop the bus' worker thread once the transaction it is running, if
+ *  any, is done. Transactions still queued stay queued.
+ */
+void
+MCP41HVX1_Async_Stop (MCP41HVX1_Async *async)
+{
+    async->stopping = 1;
+    MCP41HVX1_Os_Signal_Raise (&async->work);
+    MCP41HVX1_Os_Signal_Wait (&async->stopped, MCP_OS_FOREVER);
+}
+
+void
+MCP41HVX1_Future_Init (MCP41HVX1_Future *future,
+                       void (*callback) (MCP41HVX1_Future *future),
+                       void *context)
+{
+    future->txn.state = MCP_TXN_IDLE;
+    future->complete = 0;
+    future->callback = callback;
+    future->context = context;
+    MCP41HVX1_Os_Signal_Init (&future->done);
+}
+
+/**
+ *  HAL_StatusTypeDef MCP41HVX1_Async_Submit(MCP41HVX1_Async *async, MCP41HVX1_Future *future)
+ *
+ *  Submit the transaction of a future, set up with any of the
+ *  MCP41HVX1_Txn helpers, to the bus' worker. May be called from threads
+ *  and interrupts. The future must not be submitted again until it is
+ *  done or cancelled.
+ *
+ *  Returns a HAL_StatusTypeDef indicating success or failure.
+ */
+HAL_StatusTypeDef
+MCP41HVX1_Async_Submit (MCP41HVX1_Async *async, MCP41HVX1_Future *future)
+{
+    if (__MCP_TXN_PENDING (&future->txn))
+    {
+        return HAL_BUSY;
+    }
+
+    future->complete = 0;
+    future->txn.done = _async_done;
+    future->txn.context = future;
+
+    HAL_StatusTypeDef status = MCP41HVX1_Sched_Submit (&async->sched, &future->txn);
+    if (status == HAL_OK)
+        MCP41HVX1_Os_Signal_Raise (&async->work);
+
+    return status;
+}
+
+/**
+ *  HAL_StatusTypeDef MCP41HVX1_Async_Write(MCP41HVX1_Async *async, MCP41HVX1_Future *future,
+ *                                          MCP41HVX1 *mcp, uint8_t code, uint8_t priority,
+ *                                          uint32_t deadline)
+ *
+ *  Submit a resistance code write to a device, due deadline milliseconds
+ *  from now.
+ *
+ *  Returns a HAL_StatusTypeDef indicating success or failure.
+ */
+HAL_StatusTypeDef
+MCP41HVX1_Async_Write (MCP41HVX1_Async *async,
+                       MCP41HVX1_Future *future,
+                       MCP41HVX1 *mcp,
+                       uint8_t code,
+                       uint8_t priority,
+                       uint32_t deadline)
+{
+    if (__MCP_TXN_PENDING (&future->txn))
+    {
+        return HAL_BUSY;
+    }
+
+    MCP41HVX1_Txn_Write (&future->txn, mcp, code, priority, deadline);
+    return MCP41HVX1_Async_Submit (async, future);
+}
+
+/**
+ *  HAL_StatusTypeDef MCP41HVX1_Async_Read(MCP41HVX1_Async *async, MCP41HVX1_Future *future,
+ *                                         MCP41HVX1 *mcp, uint8_t priority, uint32_t deadline)
+ *
+ *  Submit a resistance code read from a device, due deadline milliseconds
+ *  from now. Once done the code read is in future->txn.rx[1].
+ *
+ *  Returns a HAL_StatusTypeDef indicating success or failure.
+ */
+HAL_StatusTypeDef
+MCP41HVX1_Async_Read (MCP41HVX1_Async *async,
+                      MCP41HVX1_Future *future,
+                      MCP41HVX1 *mcp,
+                      uint8_t priority,
+                      uint32_t deadline)
+{
+    if (__MCP_TXN_PENDING (&future->txn))
+    {
+        return HAL_BUSY;
+    }
+
+    MCP41HVX1_Txn_Read (&future->txn, mcp, priority, deadline);
+    return MCP41HVX1_Async_Submit (async, future);
+}
+
+/**
+ *  HAL_StatusTypeDef MCP41HVX1_Async_Cancel(MCP41HVX1_Async *async, MCP41HVX1_Future *future)
+ *
+ *  Cancel a future whose transaction is still queued. A cancelled
+ *  future is never completed and may be submitted again straight away.
+ *
+ *  Returns the status of MCP41HVX1_Sched_Cancel, HAL_BUSY if the worker
+ *  is already running the transaction and it has to be waited for.
+ */
+HAL_StatusTypeDef
+MCP41HVX1_Async_Cancel (MCP41HVX1_Async *async, MCP41HVX1_Future *future)
+{
+    return MCP41HVX1_Sched_Cancel (&async->sched, &future->txn);
+}
+
+/**
+ *  HAL_StatusTypeDef MCP41HVX1_Future_Wait(MCP41HVX1_Future *future, uint32_t timeout)
+ *
+ *  Wait up to timeout milliseconds (MCP_OS_FOREVER for no limit) for the
+ *  future's transaction to be done. A transaction timed out on stays
+ *  queued and can still be waited for again or cancelled.
+ *
+ *  Returns HAL_TIMEOUT if the transaction isn't done in time, otherwise
+ *  its status.
+ */
+HAL_StatusTypeDef
+MCP41HVX1_Future_Wait (MCP41HVX1_Future *future, uint32_t timeout)
+{
+    // Never submitted or cancelled, there is nothing to wait for
+    uint32_t state = MCP41HVX1_Os_Critical_Enter ();
+    uint8_t idle = (future->txn.state == MCP_TXN_IDLE);
+    MCP41HVX1_Os_Critical_Exit (state);
+
+    if (idle)
+    {
+        return HAL_ERROR;
+    }
+
+    // The signal may still be raised from an earlier transaction nobody
+    // waited for, which only costs another pass
+    while (!_async_complete (future))
+    {
+        if (MCP41HVX1_Os_Signal_Wait (&future->done, timeout) != HAL_OK)
+            return HAL_TIMEOUT;
+    }
+
+    return future->txn.status;
+}
+
+uint8_t
+MCP41HVX1_Future_Done (MCP41HVX1_Future *future)
+{
+    return _async_complete (future);
+}
+#endif
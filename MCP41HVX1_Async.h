@@ -0,0 +1,87 @@
+/**
+ *      MCP41HVX1 STM32F7 SPI Driver - Asynchronous API
+ *
+ *      Author:     Ethan Garnier
+ *      Date:       2025
+ */
+#ifndef MCP41HVX1_ASYNC_H
+#define MCP41HVX1_ASYNC_H
+
+#include "MCP41HVX1_Os.h"
+#include "MCP41HVX1_Sched.h"
+
+#ifdef MCP41HVX1_OS
+// NOTE(Ethan): Called directly, the driver leaves tasks sharing a bus to
+// fight over its lock and retry whenever they get HAL_BUSY. The
+// asynchronous API instead gives every bus a worker thread running its
+// scheduler (MCP41HVX1_Sched.h), which becomes the only user of the bus.
+// Tasks and interrupts submit transactions, each tracked by a future, and
+// carry on: a task can later wait for the future with a timeout, and the
+// future's callback, if any, runs on the worker once the transaction is
+// done. Transactions still go by priority class and deadline.
+//
+//  The worker sleeps while there is nothing to do. A transaction runs
+//  through the bus' transport on the worker, so giving the devices the
+//  MCP_WAIT_EVENT or MCP_WAIT_YIELD wait strategy lets the worker give up
+//  the core during long transfers as well.
+
+// Time the worker waits before trying a bus held outside the scheduler
+// again, and how often it gives the scheduler's idle hook a chance to
+// queue background work, in milliseconds
+#define MCP_ASYNC_BUSY_MS 1
+#define MCP_ASYNC_IDLE_MS 1
+
+/* MCP41HVX1 Future Struct */
+typedef struct MCP41HVX1_Future
+{
+    // Transaction the future tracks, once done its status is the
+    // outcome and a read's value is in rx[1]
+    MCP41HVX1_Txn txn;
+
+    // Called on the worker once the transaction is done, may be NULL
+    void (*callback) (struct MCP41HVX1_Future *future);
+    void *context;
+
+    // Set and raised once the transaction is done and its callback has run
+    volatile uint8_t complete;
+    MCP41HVX1_Os_Signal done;
+} MCP41HVX1_Future;
+
+/* MCP41HVX1 Asynchronous Bus Struct */
+typedef struct
+{
+    MCP41HVX1_Sched sched;
+
+    // Raised whenever there is work for the worker, and by the worker
+    // once it has stopped
+    MCP41HVX1_Os_Signal work;
+    MCP41HVX1_Os_Signal stopped;
+    volatile uint8_t stopping;
+} MCP41HVX1_Async;
+
+HAL_StatusTypeDef MCP41HVX1_Async_Init (MCP41HVX1_Async *async, MCP41HVX1 *mcp);
+HAL_StatusTypeDef MCP41HVX1_Async_Start (MCP41HVX1_Async *async,
+                                         uint32_t priority,
+                                         uint32_t stackBytes);
+void MCP41HVX1_Async_Stop (MCP41HVX1_Async *async);
+void MCP41HVX1_Future_Init (MCP41HVX1_Future *future,
+                            void (*callback) (MCP41HVX1_Future *future),
+                            void *context);
+HAL_StatusTypeDef MCP41HVX1_Async_Submit (MCP41HVX1_Async *async, MCP41HVX1_Future *future);
+HAL_StatusTypeDef MCP41HVX1_Async_Write (MCP41HVX1_Async *async,
+                                         MCP41HVX1_Future *future,
+                                         MCP41HVX1 *mcp,
+                                         uint8_t code,
+                                         uint8_t priority,
+                                         uint32_t deadline);
+HAL_StatusTypeDef MCP41HVX1_Async_Read (MCP41HVX1_Async *async,
+                                        MCP41HVX1_Future *future,
+                                        MCP41HVX1 *mcp,
+                                        uint8_t priority,
+                                        uint32_t deadline);
+HAL_StatusTypeDef MCP41HVX1_Async_Cancel (MCP41HVX1_Async *async, MCP41HVX1_Future *future);
+HAL_StatusTypeDef MCP41HVX1_Future_Wait (MCP41HVX1_Future *future, uint32_t timeout);
+uint8_t MCP41HVX1_Future_Done (MCP41HVX1_Future *future);
+#endif
+
+#endif
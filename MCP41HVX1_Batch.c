@@ -0,0 +1,173 @@
+/**
+ *      MCP41HVX1 STM32F7 SPI Driver - Batch Code Conversion
+ *
+ *      Author:     Ethan Garnier
+ *      Date:       2025
+ */
+#include "MCP41HVX1_Batch.h"
+
+#ifndef MCP41HVX1_NO_FLOAT
+#include "math.h"
+#include "string.h"
+
+#if defined(__AVX__)
+#include "immintrin.h"
+#elif defined(__SSE2__)
+#include "emmintrin.h"
+#endif
+
+static uint8_t
+_batch_to_code (float resistance)
+{
+    // Scalar path, the same math as MCP41HVX1_To_Code but saturating
+    float steps = roundf (resistance / MCP_STEP_RESISTANCE);
+    if (!(steps > 0.0f))
+        return MCP_FSV;
+
+    if (steps >= (float)MCP_FSV)
+        return 0;
+
+    return MCP_FSV - (uint8_t)steps;
+}
+
+#if defined(__SSE2__)
+static __m128i
+_batch_to_code_sse (__m128 resistance)
+{
+    // roundf() rounds halfway cases away from zero, which none of the SIMD
+    // rounding modes do. For the non negative, clamped values here it is
+    // trunc(x) + (x - trunc(x) >= 0.5), which is exact in single precision.
+    __m128 x = _mm_div_ps (resistance, _mm_set1_ps (MCP_STEP_RESISTANCE));
+    x = _mm_min_ps (_mm_max_ps (x, _mm_setzero_ps ()), _mm_set1_ps ((float)MCP_FSV));
+
+    __m128i whole = _mm_cvttps_epi32 (x);
+    __m128 fraction = _mm_sub_ps (x, _mm_cvtepi32_ps (whole));
+    __m128i half = _mm_castps_si128 (_mm_cmpge_ps (fraction, _mm_set1_ps (0.5f)));
+
+    // half is all ones (-1) where the value rounds up
+    whole = _mm_sub_epi32 (whole, half);
+    return _mm_sub_epi32 (_mm_set1_epi32 (MCP_FSV), whole);
+}
+#endif
+
+/**
+ *  void MCP41HVX1_To_Code_Array(const float *resistances, uint8_t *codes, uint32_t count)
+ *
+ *  Convert count resistances (in ohms) to resistance codes.
+ */
+void
+MCP41HVX1_To_Code_Array (const float *resistances, uint8_t *codes, uint32_t count)
+{
+    uint32_t i = 0;
+
+#if defined(__AVX__)
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 x = _mm256_div_ps (_mm256_loadu_ps (&resistances[i]),
+                                  _mm256_set1_ps (MCP_STEP_RESISTANCE));
+        x = _mm256_min_ps (_mm256_max_ps (x, _mm256_setzero_ps ()),
+                           _mm256_set1_ps ((float)MCP_FSV));
+
+        // See _batch_to_code_sse for why the rounding is done by hand
+        __m256 whole = _mm256_round_ps (x, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+        __m256 half = _mm256_cmp_ps (_mm256_sub_ps (x, whole), _mm256_set1_ps (0.5f), _CMP_GE_OQ);
+        whole = _mm256_add_ps (whole, _mm256_and_ps (half, _mm256_set1_ps (1.0f)));
+
+        __m256i code = _mm256_cvttps_epi32 (_mm256_sub_ps (_mm256_set1_ps ((float)MCP_FSV), whole));
+        __m128i packed = _mm_packs_epi32 (_mm256_castsi256_si128 (code),
+                                          _mm256_extractf128_si256 (code, 1));
+        _mm_storel_epi64 ((__m128i *)&codes[i], _mm_packus_epi16 (packed, packed));
+    }
+#endif
+
+#if defined(__SSE2__)
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i low = _batch_to_code_sse (_mm_loadu_ps (&resistances[i]));
+        __m128i high = _batch_to_code_sse (_mm_loadu_ps (&resistances[i + 4]));
+        __m128i packed = _mm_packs_epi32 (low, high);
+        _mm_storel_epi64 ((__m128i *)&codes[i], _mm_packus_epi16 (packed, packed));
+    }
+#elif defined(__ARM_FEATURE_DSP)
+    // The Cortex-M7 FPU is scalar and the DSP extension has no floating
+    // point SIMD, so the division, clamp and rounding stay per element
+    // (VDIV, VRINTA, VCVT). Only the four step counts are handled
+    // together: packed into one word, subtracted from MCP_FSV in a single
+    // saturating SIMD instruction and stored with one word store.
+    for (; i + 4 <= count; i += 4)
+    {
+        uint32_t packed = 0;
+        for (uint32_t j = 0; j < 4; j++)
+        {
+            // Clamped before converting, a float past the range of the
+            // integer has no defined conversion. NaN counts as 0 steps
+            // like on the scalar path.
+            float x = resistances[i + j] / MCP_STEP_RESISTANCE;
+            if (!(x > 0.0f))
+                x = 0.0f;
+            else if (x > (float)MCP_FSV)
+                x = (float)MCP_FSV;
+
+            packed |= (uint32_t)roundf (x) << (8 * j);
+        }
+
+        packed = __UQSUB8 (0xFFFFFFFF, packed);
+        memcpy (&codes[i], &packed, sizeof (packed));
+    }
+#endif
+
+    for (; i < count; i++)
+        codes[i] = _batch_to_code (resistances[i]);
+}
+
+/**
+ *  void MCP41HVX1_To_Resistance_Array(const uint8_t *codes, float *resistances, uint32_t count)
+ *
+ *  Convert count resistance codes to resistances (in ohms).
+ */
+void
+MCP41HVX1_To_Resistance_Array (const uint8_t *codes, float *resistances, uint32_t count)
+{
+    uint32_t i = 0;
+
+#if defined(__SSE2__)
+    const __m128i fsv = _mm_set1_epi32 (MCP_FSV);
+    const __m128 step = _mm_set1_ps (MCP_STEP_RESISTANCE);
+    const __m128 rfs = _mm_set1_ps ((float)MCP_R_FS);
+
+    for (; i + 4 <= count; i += 4)
+    {
+        uint32_t word;
+        memcpy (&word, &codes[i], sizeof (word));
+
+        // Zero extend four codes to 32 bits
+        __m128i code = _mm_cvtsi32_si128 ((int)word);
+        code = _mm_unpacklo_epi8 (code, _mm_setzero_si128 ());
+        code = _mm_unpacklo_epi16 (code, _mm_setzero_si128 ());
+
+        __m128 steps = _mm_cvtepi32_ps (_mm_sub_epi32 (fsv, code));
+        _mm_storeu_ps (&resistances[i], _mm_add_ps (rfs, _mm_mul_ps (steps, step)));
+    }
+#elif defined(__ARM_FEATURE_DSP)
+    for (; i + 4 <= count; i += 4)
+    {
+        uint32_t word;
+        memcpy (&word, &codes[i], sizeof (word));
+
+        // Step counts of all four codes at once, then split the even and
+        // odd bytes into two pairs of halfwords
+        word = __USUB8 (0xFFFFFFFF, word);
+        uint32_t even = __UXTB16 (word);
+        uint32_t odd = __UXTB16 (__ROR (word, 8));
+
+        resistances[i] = MCP_R_FS + (float)(even & 0xFFFF) * MCP_STEP_RESISTANCE;
+        resistances[i + 1] = MCP_R_FS + (float)(odd & 0xFFFF) * MCP_STEP_RESISTANCE;
+        resistances[i + 2] = MCP_R_FS + (float)(even >> 16) * MCP_STEP_RESISTANCE;
+        resistances[i + 3] = MCP_R_FS + (float)(odd >> 16) * MCP_STEP_RESISTANCE;
+    }
+#endif
+
+    for (; i < count; i++)
+        resistances[i] = MCP41HVX1_To_Resistance (codes[i]);
+}
+#endif
@@ -0,0 +1,26 @@
+/**
+ *      MCP41HVX1 STM32F7 SPI Driver - Batch Code Conversion
+ *
+ *      Author:     Ethan Garnier
+ *      Date:       2025
+ */
+#ifndef MCP41HVX1_BATCH_H
+#define MCP41HVX1_BATCH_H
+
+#include "MCP41HVX1.h"
+
+#ifndef MCP41HVX1_NO_FLOAT
+// NOTE(Ethan): These convert whole channel arrays at once and give the
+// same results as calling MCP41HVX1_To_Code and MCP41HVX1_To_Resistance on
+// every element for resistances between 0 and MCP_R_MAX. Out of range
+// resistances saturate to code 0 or MCP_FSV instead of wrapping. The
+// implementation is picked at compile time: SSE2 or AVX on host builds,
+// the Cortex-M7 DSP extension on target, plain C anywhere else. The
+// Cortex-M7 has no floating point SIMD, so on target only the integer
+// half of each conversion is vectorized and the gain over plain C is
+// small. MCP41HVX1_Bench.c times every path against the scalar one.
+void MCP41HVX1_To_Code_Array (const float *resistances, uint8_t *codes, uint32_t count);
+void MCP41HVX1_To_Resistance_Array (const uint8_t *codes, float *resistances, uint32_t count);
+#endif
+
+#endif
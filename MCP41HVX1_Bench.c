@@ -0,0 +1,168 @@
+/**
+ *      MCP41HVX1 STM32F7 SPI Driver - Host Benchmarks
+ *
+ *      Author:     Ethan Garnier
+ *      Date:       2025
+ */
+#define _POSIX_C_SOURCE 200809L
+#include "MCP41HVX1.h"
+
+// NOTE(Ethan): Benchmarks of the driver's hot paths, built on a host as a
+// program of their own. MCP41HVX1_BENCH keeps this file, and its main,
+// out of every other build:
+//
+//      cc -O2 -DMCP41HVX1_HOST -DMCP41HVX1_BENCH MCP41HVX1*.c -lm
+//
+//  Each benchmark prints its timings next to those of the plain path it
+//  replaces, along with any result that differs between the two.
+#if defined(MCP41HVX1_HOST) && defined(MCP41HVX1_BENCH)
+#include "MCP41HVX1_Batch.h"
+#include "MCP41HVX1_Transport.h"
+#include "stdio.h"
+#include "time.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include "x86intrin.h"
+#define __BENCH_CYCLES() __rdtsc ()
+#else
+#define __BENCH_CYCLES() (0U)
+#endif
+
+// Elements converted per pass and passes timed
+#define BENCH_COUNT 4096
+#define BENCH_PASSES 2000
+
+static uint64_t
+_bench_ns (void)
+{
+    struct timespec now;
+    clock_gettime (CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+uint32_t
+HAL_GetTick (void)
+{
+    return (uint32_t)(_bench_ns () / 1000000u);
+}
+
+#ifndef MCP41HVX1_NO_FLOAT
+static float bench_resistances[BENCH_COUNT];
+static uint8_t bench_scalar[BENCH_COUNT];
+static uint8_t bench_batch[BENCH_COUNT];
+
+static void
+_bench_batch (void)
+{
+    // Setpoints spread over the whole range, off the step grid
+    for (uint32_t i = 0; i < BENCH_COUNT; i++)
+        bench_resistances[i] = (float)i * (MCP_R_MAX / (float)BENCH_COUNT) + 7.3f;
+
+    uint64_t start = _bench_ns ();
+    for (uint32_t pass = 0; pass < BENCH_PASSES; pass++)
+    {
+        for (uint32_t i = 0; i < BENCH_COUNT; i++)
+            bench_scalar[i] = MCP41HVX1_To_Code (bench_resistances[i]);
+
+        __asm__ volatile ("" : : "r"(bench_scalar) : "memory");
+    }
+    uint64_t scalar = _bench_ns () - start;
+
+    start = _bench_ns ();
+    for (uint32_t pass = 0; pass < BENCH_PASSES; pass++)
+    {
+        MCP41HVX1_To_Code_Array (bench_resistances, bench_batch, BENCH_COUNT);
+        __asm__ volatile ("" : : "r"(bench_batch) : "memory");
+    }
+    uint64_t batch = _bench_ns () - start;
+
+    uint32_t mismatches = 0;
+    for (uint32_t i = 0; i < BENCH_COUNT; i++)
+        mismatches += (bench_scalar[i] != bench_batch[i]);
+
+    double elements = (double)BENCH_COUNT * BENCH_PASSES;
+    printf ("To_Code        scalar roundf %6.2f ns/code\n", (double)scalar / elements);
+    printf ("To_Code_Array  batch         %6.2f ns/code  %.1fx  %lu mismatches\n",
+            (double)batch / elements,
+            (double)scalar / (double)batch,
+            (unsigned long)mismatches);
+}
+#endif
+
+// Write and read back every code, the traffic of one transport pass
+static uint32_t
+_bench_codes (MCP41HVX1 *mcp)
+{
+    uint32_t failures = 0;
+    for (uint16_t code = 0; code <= MCP_FSV; code++)
+    {
+        uint8_t back;
+        failures += (MCP41HVX1_Set_Resistance_Code (mcp, (uint8_t)code) != HAL_OK);
+        failures += (MCP41HVX1_Get_Resistance_Code (mcp, &back) != HAL_OK);
+    }
+
+    return failures;
+}
+
+static void
+_bench_transport (const char *name, MCP41HVX1 *mcp, uint32_t bits)
+{
+    uint32_t failures = 0;
+    uint64_t cycles = __BENCH_CYCLES ();
+    uint64_t start = _bench_ns ();
+    for (uint32_t pass = 0; pass < BENCH_PASSES; pass++)
+        failures += _bench_codes (mcp);
+    uint64_t ns = _bench_ns () - start;
+    cycles = __BENCH_CYCLES () - cycles;
+
+    double total = (double)bits * BENCH_PASSES;
+    printf ("%-14s %6.2f ns/bit  %6.2f cycles/bit  %lu failures\n",
+            name,
+            (double)ns / total,
+            (double)cycles / total,
+            (unsigned long)failures);
+}
+
+static void
+_bench_gpio (void)
+{
+    // The sim models the device's command set a byte at a time and counts
+    // the bits one pass puts on the wire, which are then clocked through
+    // the GPIO transport one at a time. Its ports are the host stand-ins
+    // with data in held high, which a device answers both commands with,
+    // so the figures are the cost of the bit loop itself.
+    static MCP41HVX1_Sim sim;
+    MCP41HVX1_Sim_Init (&sim, MCP_FSV);
+    MCP41HVX1 simDevice;
+    MCP41HVX1_Init_Transport (&simDevice, &MCP41HVX1_Sim_Transport, &sim, NULL, 0);
+
+    _bench_codes (&simDevice);
+    uint32_t bits = sim.bytes * 8;
+    printf ("Transports     %lu bits per pass\n", (unsigned long)bits);
+    _bench_transport ("Sim", &simDevice, bits);
+
+    static GPIO_TypeDef clockPort, dataPort, csPort;
+    dataPort.IDR = 0xFFFF;
+
+    static MCP41HVX1_GPIO_Bus shared, split;
+    MCP41HVX1_GPIO_Init (&shared, &clockPort, 1 << 5, &clockPort, 1 << 7, &dataPort, 1 << 9);
+    MCP41HVX1_GPIO_Init (&split, &clockPort, 1 << 5, &dataPort, 1 << 7, &dataPort, 1 << 9);
+
+    MCP41HVX1 device;
+    MCP41HVX1_Init_Transport (&device, &MCP41HVX1_GPIO_Transport, &shared, &csPort, 1 << 3);
+    _bench_transport ("GPIO shared", &device, bits);
+
+    MCP41HVX1_Init_Transport (&device, &MCP41HVX1_GPIO_Transport, &split, &csPort, 1 << 3);
+    _bench_transport ("GPIO split", &device, bits);
+}
+
+int
+main (void)
+{
+#ifndef MCP41HVX1_NO_FLOAT
+    _bench_batch ();
+#endif
+    _bench_gpio ();
+    return 0;
+}
+#endif
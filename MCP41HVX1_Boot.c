@@ -0,0 +1,172 @@
+/**
+ *      MCP41HVX1 STM32F7 SPI Driver - Boot Time Bring-up
+ *
+ *      Author:     Ethan Garnier
+ *      Date:       2025
+ */
+#define _POSIX_C_SOURCE 200809L
+#include "MCP41HVX1_Boot.h"
+#include "MCP41HVX1_Transport.h"
+
+#ifdef MCP41HVX1_HOST
+#include "time.h"
+#endif
+
+// Bytes in the frame every device is brought up with
+#define MCP_BOOT_FRAME 6
+
+// Time since an arbitrary start, in cycles on target and in microseconds
+// on host builds
+static uint32_t
+_boot_now (void)
+{
+#ifndef MCP41HVX1_HOST
+    if (!(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk))
+    {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+
+    return DWT->CYCCNT;
+#else
+    // Monotonic, wall clock time may be stepped while a burst is timed
+    struct timespec now;
+    clock_gettime (CLOCK_MONOTONIC, &now);
+    return (uint32_t)now.tv_sec * 1000000u + (uint32_t)(now.tv_nsec / 1000);
+#endif
+}
+
+// Devices are done in the same burst if the bus needs no reconfiguring
+// between them
+static uint8_t
+_boot_same_burst (const MCP41HVX1 *a, const MCP41HVX1 *b)
+{
+    return a->bus == b->bus && a->transport == b->transport && a->maxSckHz == b->maxSckHz;
+}
+
+/**
+ *  HAL_StatusTypeDef MCP41HVX1_Boot(MCP41HVX1 *const *devices, const MCP41HVX1_Boot_State *states,
+ *                                   uint8_t count, MCP41HVX1_Boot_Report *report)
+ *
+ *  Probe count initialized devices and bring each up with its state,
+ *  typically the last known state restored from a snapshot. A NULL states
+ *  brings every device up at its power-on state (mid-scale, terminals
+ *  connected). report, which may be NULL, tells which devices are present
+ *  and how long the bring-up took.
+ *
+ *  Returns HAL_OK if every device is present, HAL_ERROR if any is missing
+ *  or didn't take its state, or the status of a bus that failed.
+ */
+HAL_StatusTypeDef
+MCP41HVX1_Boot (MCP41HVX1 *const *devices,
+                const MCP41HVX1_Boot_State *states,
+                uint8_t count,
+                MCP41HVX1_Boot_Report *report)
+{
+    if (count == 0 || count > MCP_BOOT_MAX)
+    {
+        return HAL_ERROR;
+    }
+
+    uint32_t start = _boot_now ();
+
+    // Every frame's buffers have to outlive its burst, a transport may
+    // hold back the whole burst until the bus is released
+    uint8_t tx[MCP_BOOT_MAX][MCP_BOOT_FRAME];
+    uint8_t rx[MCP_BOOT_MAX][MCP_BOOT_FRAME];
+    uint8_t done[MCP_BOOT_MAX] = { 0 };
+    uint8_t bursts = 0;
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        MCP41HVX1 *mcp = devices[i];
+        uint8_t fsv = __MCP_FSV (mcp);
+        uint8_t wiper = states ? states[i].wiper : (uint8_t)((fsv + 1) / 2);
+
+        tx[i][0] = MCP_CMD_WRITE_TCON;
+        tx[i][1] = states ? states[i].tcon : 0xFF;
+        tx[i][2] = 0x00;
+        tx[i][3] = __MCP_CLAMP_CODE (mcp, wiper);
+        tx[i][4] = 0x0C;
+        tx[i][5] = 0x00;
+
+        for (uint8_t b = 0; b < MCP_BOOT_FRAME; b++)
+            rx[i][b] = 0x00;
+    }
+
+    HAL_StatusTypeDef result = HAL_OK;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if (done[i])
+            continue;
+
+        // The first device not yet done leads the burst, picking up every
+        // later device the bus can reach without being reconfigured
+        HAL_StatusTypeDef status = __MCP_ACQUIRE (devices[i]);
+        uint8_t acquired = (status == HAL_OK);
+        for (uint8_t j = i; j < count; j++)
+        {
+            if (done[j] || !_boot_same_burst (devices[i], devices[j]))
+                continue;
+
+            done[j] = 1;
+            if (status != HAL_OK)
+                continue;
+
+            __MCP_XPORT_SELECT (devices[j]);
+            status = __MCP_TRANSFER (devices[j], tx[j], rx[j], MCP_BOOT_FRAME);
+            __MCP_XPORT_UNSELECT (devices[j]);
+        }
+
+        if (acquired)
+        {
+            __MCP_RELEASE (devices[i]);
+            bursts++;
+        }
+
+        // Devices of a failed burst are reported missing
+        if (status != HAL_OK)
+        {
+            result = status;
+            for (uint8_t j = i; j < count; j++)
+            {
+                if (_boot_same_burst (devices[i], devices[j]))
+                    rx[j][0] = 0x00;
+            }
+        }
+    }
+
+    uint8_t found = 0;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        // If CMDERR (bit 7) is low for any command, then an error has occured
+        uint8_t acked = rx[i][0] & rx[i][2] & rx[i][4] & 0x02;
+        uint8_t present = acked && rx[i][5] == tx[i][3];
+        if (!acked)
+            devices[i]->errors.cmderr++;
+
+        found += present;
+        if (report)
+            report->present[i] = present;
+    }
+
+    uint32_t elapsed = _boot_now () - start;
+    if (report)
+    {
+        report->found = found;
+        report->bursts = bursts;
+#ifndef MCP41HVX1_HOST
+        report->cycles = elapsed;
+        report->us = elapsed / (SystemCoreClock / 1000000);
+#else
+        report->cycles = 0;
+        report->us = elapsed;
+#endif
+    }
+
+    if (result != HAL_OK)
+        return result;
+
+    return (found == count) ? HAL_OK : HAL_ERROR;
+}
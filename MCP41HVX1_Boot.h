@@ -0,0 +1,59 @@
+/**
+ *      MCP41HVX1 STM32F7 SPI Driver - Boot Time Bring-up
+ *
+ *      Author:     Ethan Garnier
+ *      Date:       2025
+ */
+#ifndef MCP41HVX1_BOOT_H
+#define MCP41HVX1_BOOT_H
+
+#include "MCP41HVX1.h"
+
+// NOTE(Ethan): Bringing devices up one call at a time (Startup, then
+// Set_Resistance_Code, then reading back) costs a bus setup and a frame
+// per command per device. MCP41HVX1_Boot brings every device up in a
+// single pass instead: devices sharing a bus and SCK frequency are done in
+// one bus burst, and every device gets one chip select frame that writes
+// TCON, writes the wiper and reads the wiper back:
+//
+//      0x40 tcon  0x00 wiper  0x0C 0x00
+//
+//  A device counts as present if all three commands are acknowledged and
+//  the wiper reads back as written. A missing device answers whatever MISO
+//  floats to, which only passes for a wiper code of 0xFF on a bus whose
+//  MISO is pulled up.
+
+// Most devices brought up in one call
+#ifndef MCP_BOOT_MAX
+#define MCP_BOOT_MAX 32
+#endif
+
+/* MCP41HVX1 Boot State Struct */
+typedef struct
+{
+    // Wiper code and TCON value a device is brought up with
+    uint8_t wiper;
+    uint8_t tcon;
+} MCP41HVX1_Boot_State;
+
+/* MCP41HVX1 Boot Report Struct */
+typedef struct
+{
+    // Whether every device answered and now holds its state, and how many did
+    uint8_t present[MCP_BOOT_MAX];
+    uint8_t found;
+
+    // Bus bursts the bring-up took
+    uint8_t bursts;
+
+    // Time taken, cycles are counted on target only
+    uint32_t cycles;
+    uint32_t us;
+} MCP41HVX1_Boot_Report;
+
+HAL_StatusTypeDef MCP41HVX1_Boot (MCP41HVX1 *const *devices,
+                                  const MCP41HVX1_Boot_State *states,
+                                  uint8_t count,
+                                  MCP41HVX1_Boot_Report *report);
+
+#endif
@@ -0,0 +1,287 @@
+/**
+ *      MCP41HVX1 STM32F7 SPI Driver - Channel Table
+ *
+ *      Author:     Ethan Garnier
+ *      Date:       2025
+ */
+#include "MCP41HVX1_Channel.h"
+#include "MCP41HVX1_Transport.h"
+
+#define __CHANNEL_BIT(__CHANNEL__) (0x80000000u >> ((__CHANNEL__) & 31))
+#define __CHANNEL_WORD(__CHANNEL__) ((__CHANNEL__) >> 5)
+
+// Codes past the full scale value of a channel's part are clamped to it
+static uint8_t
+_channel_clamp (MCP41HVX1_Channel_Table *table, uint16_t channel, uint8_t code)
+{
+    return __MCP_CLAMP_CODE (table->bus[table->busId[channel]], code);
+}
+
+void
+MCP41HVX1_Channel_Init (MCP41HVX1_Channel_Table *table)
+{
+    table->busCount = 0;
+    table->count = 0;
+
+    for (uint8_t b = 0; b < MCP_CHANNEL_BUS_MAX; b++)
+    {
+        table->bus[b] = NULL;
+        for (uint16_t w = 0; w < MCP_CHANNEL_WORDS; w++)
+            table->dirty[b][w] = 0;
+    }
+}
+
+/**
+ *  HAL_StatusTypeDef MCP41HVX1_Channel_Add_Bus(MCP41HVX1_Channel_Table *table,
+ *                                              MCP41HVX1 *bus, uint8_t *busId)
+ *
+ *  Add a bus to the table. bus is an initialized device whose transport,
+ *  bus context, variant and SCK frequency every channel added to the bus
+ *  shares, its own chip select is never used.
+ *
+ *  Returns a HAL_StatusTypeDef indicating success or failure.
+ */
+HAL_StatusTypeDef
+MCP41HVX1_Channel_Add_Bus (MCP41HVX1_Channel_Table *table, MCP41HVX1 *bus, uint8_t *busId)
+{
+    if (bus == NULL || table->busCount >= MCP_CHANNEL_BUS_MAX)
+    {
+        return HAL_ERROR;
+    }
+
+    *busId = table->busCount;
+    table->bus[table->busCount++] = bus;
+    return HAL_OK;
+}
+
+/**
+ *  HAL_StatusTypeDef MCP41HVX1_Channel_Add(MCP41HVX1_Channel_Table *table, uint8_t busId,
+ *                                          GPIO_TypeDef *csPort, uint16_t csPin,
+ *                                          uint16_t *channel)
+ *
+ *  Add a channel on the given bus. The channel is assumed to hold its
+ *  power-on mid-scale code until it is first set.
+ *
+ *  Returns a HAL_StatusTypeDef indicating success or failure.
+ */
+HAL_StatusTypeDef
+MCP41HVX1_Channel_Add (MCP41HVX1_Channel_Table *table,
+                       uint8_t busId,
+                       GPIO_TypeDef *csPort,
+                       uint16_t csPin,
+                       uint16_t *channel)
+{
+    if (busId >= table->busCount || table->count >= MCP_CHANNEL_MAX)
+    {
+        return HAL_ERROR;
+    }
+
+    uint8_t fsv = __MCP_FSV (table->bus[busId]);
+
+    uint16_t c = table->count++;
+    table->csPort[c] = csPort;
+    table->csPin[c] = csPin;
+    table->busId[c] = busId;
+    table->shadow[c] = (uint8_t)((fsv + 1) / 2);
+    table->pending[c] = table->shadow[c];
+    table->back[c] = table->shadow[c];
+
+    *channel = c;
+    return HAL_OK;
+}
+
+void
+MCP41HVX1_Channel_Set (MCP41HVX1_Channel_Table *table, uint16_t channel, uint8_t code)
+{
+    code = _channel_clamp (table, channel, code);
+
+    uint32_t *word = &table->dirty[table->busId[channel]][__CHANNEL_WORD (channel)];
+    table->pending[channel] = code;
+    table->back[channel] = code;
+
+    // Setting a channel back to its shadow before a refresh cancels the write
+    if (code != table->shadow[channel])
+        *word |= __CHANNEL_BIT (channel);
+    else
+        *word &= ~__CHANNEL_BIT (channel);
+}
+
+uint8_t
+MCP41HVX1_Channel_Get (MCP41HVX1_Channel_Table *table, uint16_t channel)
+{
+    return table->pending[channel];
+}
+
+// Most channels written in one bus burst, bounding the responses held
+// on the stack until the bus is released
+#define MCP_CHANNEL_BURST 32
+
+/**
+ *  HAL_StatusTypeDef _channel_refresh_burst(MCP41HVX1_Channel_Table *table, uint8_t busId,
+ *                                           uint16_t *w, uint32_t *bits, uint16_t words)
+ *
+ *  Write up to MCP_CHANNEL_BURST dirty channels of a bus in a single bus
+ *  burst, each in its own chip select frame, scanning on from bitmap word
+ *  *w whose remaining dirty bits are *bits. Frames are sent straight from
+ *  the flash resident frame table, which outlives any transport holding
+ *  transfers back until release.
+ *
+ *  Returns a HAL_StatusTypeDef indicating success or failure.
+ */
+static HAL_StatusTypeDef
+_channel_refresh_burst (MCP41HVX1_Channel_Table *table,
+                        uint8_t busId,
+                        uint16_t *w,
+                        uint32_t *bits,
+                        uint16_t words)
+{
+    // Channels are reached through a copy of the bus' template device
+    // with the chip select swapped in for every frame
+    MCP41HVX1 device = *table->bus[busId];
+    HAL_StatusTypeDef status = __MCP_ACQUIRE (&device);
+    if (status != HAL_OK)
+    {
+        return status;
+    }
+
+    uint16_t channel[MCP_CHANNEL_BURST];
+    uint8_t code[MCP_CHANNEL_BURST];
+    uint8_t response[MCP_CHANNEL_BURST];
+    uint8_t scratch = 0x00;
+    uint8_t count = 0;
+
+    while (count < MCP_CHANNEL_BURST && status == HAL_OK)
+    {
+        while (*bits == 0 && ++(*w) < words)
+            *bits = table->dirty[busId][*w];
+
+        if (*bits == 0)
+            break;
+
+        uint8_t bit = __CLZ (*bits);
+        *bits &= ~(0x80000000u >> bit);
+
+        uint16_t c = (uint16_t)((*w << 5) + bit);
+        const uint8_t *frame = MCP41HVX1_FRAME (table->pending[c]);
+        device.csPort = table->csPort[c];
+        device.csPin = table->csPin[c];
+
+        response[count] = 0x00;
+        __MCP_XPORT_SELECT (&device);
+        status = __MCP_TRANSFER (&device, &frame[0], &response[count], 1);
+        if (status == HAL_OK)
+            status = __MCP_TRANSFER (&device, &frame[1], &scratch, 1);
+        __MCP_XPORT_UNSELECT (&device);
+
+        channel[count] = c;
+        code[count] = frame[1];
+        count++;
+    }
+
+    __MCP_RELEASE (&device);
+
+    // Only channels the device acknowledged (CMDERR high) are marked clean,
+    // anything else stays dirty and goes out again on the next refresh
+    uint8_t valid = 0x02;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        uint16_t c = channel[i];
+        valid &= response[i];
+        if (status != HAL_OK || !(response[i] & 0x02))
+            continue;
+
+        table->shadow[c] = code[i];
+        if (table->pending[c] == code[i])
+            table->dirty[busId][__CHANNEL_WORD (c)] &= ~__CHANNEL_BIT (c);
+    }
+
+    if (status != HAL_OK)
+        return status;
+
+    return (valid & 0x02) ? HAL_OK : HAL_ERROR;
+}
+
+/**
+ *  HAL_StatusTypeDef MCP41HVX1_Channel_Refresh(MCP41HVX1_Channel_Table *table)
+ *
+ *  Write every channel whose pending code has changed since it was last
+ *  written, bus by bus in bursts of up to MCP_CHANNEL_BURST channels.
+ *  Channels that haven't changed cost nothing beyond a zero bitmap word.
+ *  A failure on one bus doesn't stop the others from being refreshed.
+ *
+ *  Returns a HAL_StatusTypeDef indicating success or failure.
+ */
+HAL_StatusTypeDef
+MCP41HVX1_Channel_Refresh (MCP41HVX1_Channel_Table *table)
+{
+    HAL_StatusTypeDef result = HAL_OK;
+    uint16_t words = (uint16_t)((table->count + 31) / 32);
+
+    for (uint8_t b = 0; b < table->busCount; b++)
+    {
+        // Bursts carry on scanning where the previous one stopped and an
+        // idle bus is never acquired. A failed burst gives up on the bus,
+        // its channels stay dirty for the next refresh.
+        uint16_t w = 0;
+        uint32_t bits = (words > 0) ? table->dirty[b][0] : 0;
+        while (w < words)
+        {
+            while (bits == 0 && ++w < words)
+                bits = table->dirty[b][w];
+
+            if (w >= words)
+                break;
+
+            HAL_StatusTypeDef status = _channel_refresh_burst (table, b, &w, &bits, words);
+            if (status != HAL_OK)
+            {
+                result = status;
+                break;
+            }
+        }
+    }
+
+    return result;
+}
+
+void
+MCP41HVX1_Channel_Frame_Set (MCP41HVX1_Channel_Table *table, uint16_t channel, uint8_t code)
+{
+    table->back[channel] = _channel_clamp (table, channel, code);
+}
+
+/**
+ *  HAL_StatusTypeDef MCP41HVX1_Channel_Commit(MCP41HVX1_Channel_Table *table)
+ *
+ *  Commit the frame in the back buffer: diff it against the codes last
+ *  written to the channels, mark the changes dirty a bitmap word at a time
+ *  and send them all in one refresh, ordered by bus. No write of the frame
+ *  goes out before the commit, so the outputs move from one frame to the
+ *  next within a single refresh.
+ *
+ *  Returns a HAL_StatusTypeDef indicating success or failure. On failure
+ *  the channels not written stay dirty and go out with the next refresh.
+ */
+HAL_StatusTypeDef
+MCP41HVX1_Channel_Commit (MCP41HVX1_Channel_Table *table)
+{
+    for (uint16_t base = 0; base < table->count; base += 32)
+    {
+        uint16_t end = (table->count - base < 32) ? table->count : (uint16_t)(base + 32);
+        uint16_t w = __CHANNEL_WORD (base);
+
+        // Rebuild each bus' dirty word for this group of channels from
+        // scratch, the frame supersedes any write still pending
+        for (uint8_t b = 0; b < table->busCount; b++)
+            table->dirty[b][w] = 0;
+
+        for (uint16_t c = base; c < end; c++)
+        {
+            table->pending[c] = table->back[c];
+            if (table->back[c] != table->shadow[c])
+                table->dirty[table->busId[c]][w] |= __CHANNEL_BIT (c);
+        }
+    }
+
+    return MCP41HVX1_Channel_Refresh (table);
+}
@@ -0,0 +1,80 @@
+/**
+ *      MCP41HVX1 STM32F7 SPI Driver - Channel Table
+ *
+ *      Author:     Ethan Garnier
+ *      Date:       2025
+ */
+#ifndef MCP41HVX1_CHANNEL_H
+#define MCP41HVX1_CHANNEL_H
+
+#include "MCP41HVX1.h"
+
+// Maximum number of channels and buses a table can hold
+#ifndef MCP_CHANNEL_MAX
+#define MCP_CHANNEL_MAX 256
+#endif
+#ifndef MCP_CHANNEL_BUS_MAX
+#define MCP_CHANNEL_BUS_MAX 8
+#endif
+
+// Number of 32 bit words in a per channel bitmap
+#define MCP_CHANNEL_WORDS ((MCP_CHANNEL_MAX + 31) / 32)
+
+// NOTE(Ethan): Channels are kept as a structure of arrays indexed by
+// channel number rather than as an array of MCP41HVX1 structs, so a refresh
+// only walks the bytes it needs. Everything channels on one bus have in
+// common (transport, bus context, variant, SCK frequency) lives in a
+// template device per bus, and a channel only adds its chip select.
+//
+//  Every bus has its own dirty bitmap with a bit set for each channel
+//  whose pending code differs from the code last written to it (its
+//  shadow). Channel c is bit 31 - (c % 32) of word c / 32, so counting
+//  leading zeros yields dirty channels in ascending order.
+//
+//  For whole frames of setpoints computed at once, codes are written into
+//  the back buffer with MCP41HVX1_Channel_Frame_Set and nothing goes out
+//  until MCP41HVX1_Channel_Commit, which sends every change of the frame
+//  in one refresh. The back buffer keeps the last committed frame, so only
+//  the codes that change need writing.
+
+/* MCP41HVX1 Channel Table Struct */
+typedef struct
+{
+    // Template device of every bus, indexed by bus id
+    MCP41HVX1 *bus[MCP_CHANNEL_BUS_MAX];
+    uint8_t busCount;
+
+    // Chip select and bus id of every channel
+    GPIO_TypeDef *csPort[MCP_CHANNEL_MAX];
+    uint16_t csPin[MCP_CHANNEL_MAX];
+    uint8_t busId[MCP_CHANNEL_MAX];
+
+    // Code last written to every channel and code to be written next
+    uint8_t shadow[MCP_CHANNEL_MAX];
+    uint8_t pending[MCP_CHANNEL_MAX];
+
+    // Frame being built, committed to the pending codes as a whole
+    uint8_t back[MCP_CHANNEL_MAX];
+
+    // Channels whose pending code differs from their shadow, per bus
+    uint32_t dirty[MCP_CHANNEL_BUS_MAX][MCP_CHANNEL_WORDS];
+
+    uint16_t count;
+} MCP41HVX1_Channel_Table;
+
+void MCP41HVX1_Channel_Init (MCP41HVX1_Channel_Table *table);
+HAL_StatusTypeDef MCP41HVX1_Channel_Add_Bus (MCP41HVX1_Channel_Table *table,
+                                             MCP41HVX1 *bus,
+                                             uint8_t *busId);
+HAL_StatusTypeDef MCP41HVX1_Channel_Add (MCP41HVX1_Channel_Table *table,
+                                         uint8_t busId,
+                                         GPIO_TypeDef *csPort,
+                                         uint16_t csPin,
+                                         uint16_t *channel);
+void MCP41HVX1_Channel_Set (MCP41HVX1_Channel_Table *table, uint16_t channel, uint8_t code);
+uint8_t MCP41HVX1_Channel_Get (MCP41HVX1_Channel_Table *table, uint16_t channel);
+HAL_StatusTypeDef MCP41HVX1_Channel_Refresh (MCP41HVX1_Channel_Table *table);
+void MCP41HVX1_Channel_Frame_Set (MCP41HVX1_Channel_Table *table, uint16_t channel, uint8_t code);
+HAL_StatusTypeDef MCP41HVX1_Channel_Commit (MCP41HVX1_Channel_Table *table);
+
+#endif
@@ -0,0 +1,145 @@
+/**
+ *      MCP41HVX1 STM32F7 SPI Driver - Sub-LSB Code Dithering
+ *
+ *      Author:     Ethan Garnier
+ *      Date:       2025
+ */
+#include "MCP41HVX1_Dither.h"
+
+/**
+ *  uint32_t MCP41HVX1_Dither_To_Code(uint32_t milliohms, uint8_t bits)
+ *
+ *  Convert a resistance in milliohms to a fractional code with the given
+ *  number of fraction bits using integer math only. Resistances beyond the
+ *  range of the pot are clamped to code 0 or MCP_FSV.
+ *
+ *  Returns the fractional code.
+ */
+uint32_t
+MCP41HVX1_Dither_To_Code (uint32_t milliohms, uint8_t bits)
+{
+    uint64_t steps = (((uint64_t)milliohms << bits) + MCP_STEP_RESISTANCE_MOHM / 2)
+                     / MCP_STEP_RESISTANCE_MOHM;
+    uint64_t full = (uint64_t)MCP_FSV << bits;
+
+    return (steps >= full) ? 0 : (uint32_t)(full - steps);
+}
+
+uint32_t
+MCP41HVX1_Dither_To_Milliohms (uint32_t codeQ, uint8_t bits)
+{
+    uint64_t steps = ((uint64_t)MCP_FSV << bits) - codeQ;
+    return (uint32_t)((steps * MCP_STEP_RESISTANCE_MOHM + (1u << bits) / 2) >> bits);
+}
+
+/**
+ *  void MCP41HVX1_Dither_Pattern(uint32_t codeQ, uint8_t bits, uint8_t *codes)
+ *
+ *  Generate one period (1 << bits codes) of a first order sigma-delta
+ *  pattern between the two codes surrounding codeQ. The mean of the period
+ *  is exactly codeQ and the +1 codes are spread as evenly as possible,
+ *  which pushes the dither energy to the highest possible frequency.
+ */
+void
+MCP41HVX1_Dither_Pattern (uint32_t codeQ, uint8_t bits, uint8_t *codes)
+{
+    uint32_t one = 1u << bits;
+    uint32_t fraction = codeQ & (one - 1);
+    uint8_t base = (uint8_t)(codeQ >> bits);
+    uint32_t accumulator = 0;
+
+    for (uint32_t i = 0; i < one; i++)
+    {
+        accumulator += fraction;
+        if (accumulator >= one)
+        {
+            accumulator -= one;
+            codes[i] = base + 1;
+        }
+        else
+        {
+            codes[i] = base;
+        }
+    }
+}
+
+/**
+ *  uint32_t MCP41HVX1_Dither_Simulate(const uint8_t *codes, uint32_t length, uint8_t bits)
+ *
+ *  Model the downstream averaging filter over a stream of codes, so the
+ *  achieved setpoint can be compared against the requested one on a host.
+ *
+ *  Returns the rounded mean code as a fractional code with the given
+ *  number of fraction bits.
+ */
+uint32_t
+MCP41HVX1_Dither_Simulate (const uint8_t *codes, uint32_t length, uint8_t bits)
+{
+    if (length == 0)
+    {
+        return 0;
+    }
+
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < length; i++)
+        sum += codes[i];
+
+    return (uint32_t)(((sum << bits) + length / 2) / length);
+}
+
+#ifndef MCP41HVX1_HOST
+/**
+ *  HAL_StatusTypeDef MCP41HVX1_Dither_Start(MCP41HVX1_Dither *dither, MCP41HVX1 *mcp,
+ *                                           uint32_t milliohms, uint8_t bits)
+ *
+ *  Start dithering the device around a resistance given in milliohms with
+ *  bits of extra resolution. The pattern is played by DMA from the flash
+ *  resident frame table, one frame per call to MCP41HVX1_Dither_Trigger,
+ *  so the dither rate is set by the timer interrupt calling it. The
+ *  dither must be zero initialized before it is first started.
+ *
+ *  Returns HAL_BUSY if the dither is still playing, including until a stop
+ *  takes effect. Otherwise a HAL_StatusTypeDef indicating success or failure.
+ */
+HAL_StatusTypeDef
+MCP41HVX1_Dither_Start (MCP41HVX1_Dither *dither, MCP41HVX1 *mcp, uint32_t milliohms, uint8_t bits)
+{
+    if (bits == 0 || bits > MCP_DITHER_MAX_BITS)
+    {
+        return HAL_ERROR;
+    }
+
+    // The chain is being sent by the DMA while the dither plays, it can't
+    // be rebuilt under it
+    if (dither->stream.busy)
+    {
+        return HAL_BUSY;
+    }
+
+    uint8_t codes[1 << MCP_DITHER_MAX_BITS];
+
+    dither->codeQ = MCP41HVX1_Dither_To_Code (milliohms, bits);
+    dither->bits = bits;
+
+    MCP41HVX1_Dither_Pattern (dither->codeQ, bits, codes);
+    MCP41HVX1_Stream_Build (codes, 1u << bits, dither->chain);
+
+    return MCP41HVX1_Stream_Start (&dither->stream,
+                                   mcp,
+                                   dither->chain,
+                                   1u << bits,
+                                   MCP_STREAM_LOOP | MCP_STREAM_PACED);
+}
+
+void
+MCP41HVX1_Dither_Trigger (MCP41HVX1_Dither *dither)
+{
+    MCP41HVX1_Stream_Trigger (&dither->stream);
+}
+
+void
+MCP41HVX1_Dither_Stop (MCP41HVX1_Dither *dither)
+{
+    MCP41HVX1_Stream_Stop (&dither->stream);
+}
+#endif
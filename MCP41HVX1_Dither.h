@@ -0,0 +1,49 @@
+/**
+ *      MCP41HVX1 STM32F7 SPI Driver - Sub-LSB Code Dithering
+ *
+ *      Author:     Ethan Garnier
+ *      Date:       2025
+ */
+#ifndef MCP41HVX1_DITHER_H
+#define MCP41HVX1_DITHER_H
+
+#include "MCP41HVX1.h"
+
+// NOTE(Ethan): Dithering toggles the wiper between two adjacent codes
+// with a first order sigma-delta pattern. A low bandwidth filter after the
+// pot averages the pattern into a setpoint between the two codes, giving
+// MCP_DITHER_MAX_BITS extra bits of resolution on top of the 8-bit code
+// (e.g. 4 extra bits for an effective 12-bit setpoint). Fractional codes
+// are unsigned fixed point values with the given number of fraction bits.
+#ifndef MCP_DITHER_MAX_BITS
+#define MCP_DITHER_MAX_BITS 6
+#endif
+
+/* MCP41HVX1 Dither Struct */
+typedef struct
+{
+    // DMA stream playing the pattern, busy until the dither is stopped
+    MCP41HVX1_Stream stream;
+
+    // One pattern period of pre-encoded frames
+    const uint8_t *chain[1 << MCP_DITHER_MAX_BITS];
+
+    // Fractional code being dithered and its number of fraction bits
+    uint32_t codeQ;
+    uint8_t bits;
+} MCP41HVX1_Dither;
+
+// Hardware independent, also available in host builds
+uint32_t MCP41HVX1_Dither_To_Code (uint32_t milliohms, uint8_t bits);
+uint32_t MCP41HVX1_Dither_To_Milliohms (uint32_t codeQ, uint8_t bits);
+void MCP41HVX1_Dither_Pattern (uint32_t codeQ, uint8_t bits, uint8_t *codes);
+uint32_t MCP41HVX1_Dither_Simulate (const uint8_t *codes, uint32_t length, uint8_t bits);
+
+HAL_StatusTypeDef MCP41HVX1_Dither_Start (MCP41HVX1_Dither *dither,
+                                          MCP41HVX1 *mcp,
+                                          uint32_t milliohms,
+                                          uint8_t bits);
+void MCP41HVX1_Dither_Trigger (MCP41HVX1_Dither *dither);
+void MCP41HVX1_Dither_Stop (MCP41HVX1_Dither *dither);
+
+#endif
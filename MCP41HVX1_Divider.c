@@ -0,0 +1,136 @@
+/**
+ *      MCP41HVX1 STM32F7 SPI Driver - Voltage Divider and Loaded Rheostat Solver
+ *
+ *      Author:     Ethan Garnier
+ *      Date:       2025
+ */
+#include "MCP41HVX1_Divider.h"
+
+static uint64_t
+_divider_div (uint64_t numerator, uint64_t denominator)
+{
+    // Rounded integer division
+    return (denominator == 0) ? 0 : (numerator + denominator / 2) / denominator;
+}
+
+/**
+ *  uint8_t _divider_search(const uint32_t *table, uint32_t value, uint8_t falling)
+ *
+ *  Binary search a monotonic table of MCP_FSV + 1 entries, rising with the
+ *  code unless falling is set.
+ *
+ *  Returns the code whose table entry is closest to value.
+ */
+static uint8_t
+_divider_search (const uint32_t *table, uint32_t value, uint8_t falling)
+{
+    uint16_t low = 0;
+    uint16_t high = MCP_FSV + 1;
+
+    // First code whose entry is at or past value in table order
+    while (low < high)
+    {
+        uint16_t mid = (low + high) / 2;
+        uint8_t before = falling ? (table[mid] > value) : (table[mid] < value);
+        if (before)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    if (low > MCP_FSV)
+        return MCP_FSV;
+
+    if (low == 0)
+        return 0;
+
+    uint32_t here = (table[low] > value) ? table[low] - value : value - table[low];
+    uint32_t prev = (table[low - 1] > value) ? table[low - 1] - value : value - table[low - 1];
+
+    return (prev < here) ? (uint8_t)(low - 1) : (uint8_t)low;
+}
+
+/**
+ *  void MCP41HVX1_Divider_Init(MCP41HVX1_Divider *divider, uint32_t rab, uint32_t wiper,
+ *                              uint32_t load)
+ *
+ *  Precompute the divider ratio and loaded rheostat resistance of every
+ *  code for a device with the given end to end resistance, wiper
+ *  resistance and load (all in milliohms, MCP_DIVIDER_NO_LOAD for none).
+ *  Only 64-bit integer math is used so the FPU is never touched.
+ */
+void
+MCP41HVX1_Divider_Init (MCP41HVX1_Divider *divider, uint32_t rab, uint32_t wiper, uint32_t load)
+{
+    for (uint16_t code = 0; code <= MCP_FSV; code++)
+    {
+        uint64_t rwb = _divider_div ((uint64_t)rab * code, MCP_FSV);
+        uint64_t raw = rab - rwb;
+        uint64_t rlow = rwb;
+
+        if (load != MCP_DIVIDER_NO_LOAD)
+            rlow = _divider_div (rwb * (wiper + (uint64_t)load), rwb + wiper + load);
+
+        uint64_t ratio = _divider_div (rlow << 16, raw + rlow);
+        if (load != MCP_DIVIDER_NO_LOAD)
+            ratio = _divider_div (ratio * load, (uint64_t)wiper + load);
+
+        uint64_t rheostat = raw + wiper;
+        if (load != MCP_DIVIDER_NO_LOAD)
+            rheostat = _divider_div (rheostat * load, rheostat + load);
+
+        divider->ratio[code] = (uint32_t)ratio;
+        divider->rheostat[code] = (uint32_t)rheostat;
+    }
+}
+
+uint8_t
+MCP41HVX1_Divider_Ratio_To_Code (const MCP41HVX1_Divider *divider, uint32_t ratio)
+{
+    return _divider_search (divider->ratio, ratio, 0);
+}
+
+uint8_t
+MCP41HVX1_Divider_Voltage_To_Code (const MCP41HVX1_Divider *divider,
+                                   uint32_t vinMillivolts,
+                                   uint32_t voutMillivolts)
+{
+    uint32_t ratio = (uint32_t)_divider_div ((uint64_t)voutMillivolts << 16, vinMillivolts);
+    return _divider_search (divider->ratio, ratio, 0);
+}
+
+uint8_t
+MCP41HVX1_Divider_Rheostat_To_Code (const MCP41HVX1_Divider *divider, uint32_t milliohms)
+{
+    return _divider_search (divider->rheostat, milliohms, 1);
+}
+
+HAL_StatusTypeDef
+MCP41HVX1_Divider_Set_Ratio (MCP41HVX1 *mcp, const MCP41HVX1_Divider *divider, uint32_t ratio)
+{
+    return MCP41HVX1_Set_Resistance_Code (mcp, MCP41HVX1_Divider_Ratio_To_Code (divider, ratio));
+}
+
+HAL_StatusTypeDef
+MCP41HVX1_Divider_Set_Voltage (MCP41HVX1 *mcp,
+                               const MCP41HVX1_Divider *divider,
+                               uint32_t vinMillivolts,
+                               uint32_t voutMillivolts)
+{
+    if (vinMillivolts == 0)
+    {
+        return HAL_ERROR;
+    }
+
+    uint8_t code = MCP41HVX1_Divider_Voltage_To_Code (divider, vinMillivolts, voutMillivolts);
+    return MCP41HVX1_Set_Resistance_Code (mcp, code);
+}
+
+HAL_StatusTypeDef
+MCP41HVX1_Divider_Set_Rheostat (MCP41HVX1 *mcp,
+                                const MCP41HVX1_Divider *divider,
+                                uint32_t milliohms)
+{
+    uint8_t code = MCP41HVX1_Divider_Rheostat_To_Code (divider, milliohms);
+    return MCP41HVX1_Set_Resistance_Code (mcp, code);
+}
@@ -0,0 +1,56 @@
+/**
+ *      MCP41HVX1 STM32F7 SPI Driver - Voltage Divider and Loaded Rheostat Solver
+ *
+ *      Author:     Ethan Garnier
+ *      Date:       2025
+ */
+#ifndef MCP41HVX1_DIVIDER_H
+#define MCP41HVX1_DIVIDER_H
+
+#include "MCP41HVX1.h"
+
+// NOTE(Ethan): Terminal A is the top of the divider, B is grounded and
+// the wiper drives an optional load to ground through the wiper
+// resistance Rw. Following MCP41HVX1_To_Resistance, the A to wiper
+// resistance falls as the code rises:
+//      Raw = (FSV - code) * Rab / FSV,  Rwb = code * Rab / FSV
+//      Vout / Vin = Rlow / (Raw + Rlow) * Rl / (Rw + Rl)
+//  where Rlow = Rwb || (Rw + Rl), or just Rwb with no load. In rheostat
+//  mode the load is connected across A and the wiper, so the resistance
+//  seen is (Raw + Rw) || Rl. Ratios are unsigned Q16 fixed point values
+//  (65536 is 1.0) and resistances are in milliohms.
+#define MCP_DIVIDER_ONE 65536
+#define MCP_DIVIDER_NO_LOAD 0
+
+/* MCP41HVX1 Divider Struct */
+typedef struct
+{
+    // Output to input ratio of every code, rising with the code
+    uint32_t ratio[MCP_FSV + 1];
+
+    // Loaded rheostat resistance of every code, falling with the code
+    uint32_t rheostat[MCP_FSV + 1];
+} MCP41HVX1_Divider;
+
+void MCP41HVX1_Divider_Init (MCP41HVX1_Divider *divider,
+                             uint32_t rab,
+                             uint32_t wiper,
+                             uint32_t load);
+uint8_t MCP41HVX1_Divider_Ratio_To_Code (const MCP41HVX1_Divider *divider, uint32_t ratio);
+uint8_t MCP41HVX1_Divider_Voltage_To_Code (const MCP41HVX1_Divider *divider,
+                                           uint32_t vinMillivolts,
+                                           uint32_t voutMillivolts);
+uint8_t MCP41HVX1_Divider_Rheostat_To_Code (const MCP41HVX1_Divider *divider,
+                                            uint32_t milliohms);
+HAL_StatusTypeDef MCP41HVX1_Divider_Set_Ratio (MCP41HVX1 *mcp,
+                                               const MCP41HVX1_Divider *divider,
+                                               uint32_t ratio);
+HAL_StatusTypeDef MCP41HVX1_Divider_Set_Voltage (MCP41HVX1 *mcp,
+                                                 const MCP41HVX1_Divider *divider,
+                                                 uint32_t vinMillivolts,
+                                                 uint32_t voutMillivolts);
+HAL_StatusTypeDef MCP41HVX1_Divider_Set_Rheostat (MCP41HVX1 *mcp,
+                                                  const MCP41HVX1_Divider *divider,
+                                                  uint32_t milliohms);
+
+#endif
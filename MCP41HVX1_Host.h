@@ -0,0 +1,105 @@
+/**
+ *      MCP41HVX1 STM32F7 SPI Driver - Host Build Stand-ins
+ *
+ *      Author:     Ethan Garnier
+ *      Date:       2025
+ */
+#ifndef MCP41HVX1_HOST_H
+#define MCP41HVX1_HOST_H
+
+#include "stddef.h"
+#include "stdint.h"
+
+// NOTE(Ethan): When MCP41HVX1_HOST is defined the driver headers include
+// this file instead of stm32f7xx_hal.h. Only the types and macros the
+// driver needs are provided, laid out like their STM32F7 HAL counterparts,
+// so the driver can be built and exercised on a development machine
+// against the simulated device transport (MCP41HVX1_Transport_Sim.c).
+// Register level code still compiles but has no hardware behind it.
+
+typedef enum
+{
+    HAL_OK = 0x00U,
+    HAL_ERROR = 0x01U,
+    HAL_BUSY = 0x02U,
+    HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+
+typedef enum
+{
+    HAL_UNLOCKED = 0x00U,
+    HAL_LOCKED = 0x01U
+} HAL_LockTypeDef;
+
+typedef struct
+{
+    volatile uint32_t CR1, CR2, SR, DR, CRCPR, RXCRCR, TXCRCR, I2SCFGR, I2SPR;
+} SPI_TypeDef;
+
+typedef struct
+{
+    volatile uint32_t MODER, OTYPER, OSPEEDR, PUPDR, IDR, ODR, BSRR, LCKR, AFR[2];
+} GPIO_TypeDef;
+
+typedef struct
+{
+    volatile uint32_t CR, NDTR, PAR, M0AR, M1AR, FCR;
+} DMA_Stream_TypeDef;
+
+typedef struct
+{
+    DMA_Stream_TypeDef *Instance;
+    uint32_t StreamBaseAddress;
+    uint32_t StreamIndex;
+} DMA_HandleTypeDef;
+
+typedef struct
+{
+    SPI_TypeDef *Instance;
+    DMA_HandleTypeDef *hdmatx;
+    DMA_HandleTypeDef *hdmarx;
+    HAL_LockTypeDef Lock;
+} SPI_HandleTypeDef;
+
+// CMSIS count leading zeros, never given 0 by the driver
+#define __CLZ(__VALUE__) ((uint8_t)__builtin_clz (__VALUE__))
+
+// Interrupts can't preempt the driver on a host, masking them does nothing
+#define __get_PRIMASK() (0U)
+#define __set_PRIMASK(__MASK__) ((void)(__MASK__))
+#define __disable_irq()
+
+// Interrupt numbers, there are no interrupts to sleep on on a host
+typedef int32_t IRQn_Type;
+
+// Millisecond tick, provided by the host program
+uint32_t HAL_GetTick (void);
+
+// Clock the SPI peripherals' baud rate generators are assumed to run from
+#define MCP_HOST_PCLK 108000000U
+
+#define __HAL_LOCK(__HANDLE__)                                                                     \
+    do                                                                                             \
+    {                                                                                              \
+        if ((__HANDLE__)->Lock == HAL_LOCKED)                                                      \
+        {                                                                                          \
+            return HAL_BUSY;                                                                       \
+        }                                                                                          \
+        else                                                                                       \
+        {                                                                                          \
+            (__HANDLE__)->Lock = HAL_LOCKED;                                                       \
+        }                                                                                          \
+    } while (0U)
+
+#define __HAL_UNLOCK(__HANDLE__)                                                                   \
+    do                                                                                             \
+    {                                                                                              \
+        (__HANDLE__)->Lock = HAL_UNLOCKED;                                                         \
+    } while (0U)
+
+// DMA interrupt flags have no hardware behind them on a host
+#define __HAL_DMA_GET_TC_FLAG_INDEX(__HANDLE__) (0x00000020U << (__HANDLE__)->StreamIndex)
+#define __HAL_DMA_GET_FLAG(__HANDLE__, __FLAG__) ((void)(__HANDLE__), (__FLAG__) & 0U)
+#define __HAL_DMA_CLEAR_FLAG(__HANDLE__, __FLAG__) ((void)(__HANDLE__), (void)(__FLAG__))
+
+#endif
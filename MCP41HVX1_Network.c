@@ -0,0 +1,158 @@
+/**
+ *      MCP41HVX1 STM32F7 SPI Driver - Series/Parallel Pot Networks
+ *
+ *      Author:     Ethan Garnier
+ *      Date:       2025
+ */
+#include "MCP41HVX1_Network.h"
+
+static void
+_network_calibrate (uint32_t *resistance, const MCP41HVX1_Calibration *cal)
+{
+    // Linear interpolation between the two measured end points
+    int64_t span = (int64_t)cal->atFull - (int64_t)cal->atZero;
+    for (uint16_t code = 0; code <= MCP_FSV; code++)
+    {
+        int64_t offset = span * code;
+        offset += (offset < 0) ? -(MCP_FSV / 2) : (MCP_FSV / 2);
+        resistance[code] = (uint32_t)((int64_t)cal->atZero + offset / MCP_FSV);
+    }
+}
+
+static void
+_network_sift (MCP41HVX1_Network *network, uint32_t root, uint32_t end)
+{
+    uint16_t *sorted = network->sorted;
+
+    while (2 * root + 1 < end)
+    {
+        uint32_t child = 2 * root + 1;
+        if (child + 1 < end
+            && MCP41HVX1_Network_Resistance (network, sorted[child])
+                   < MCP41HVX1_Network_Resistance (network, sorted[child + 1]))
+            child++;
+
+        if (MCP41HVX1_Network_Resistance (network, sorted[root])
+            >= MCP41HVX1_Network_Resistance (network, sorted[child]))
+            return;
+
+        uint16_t temp = sorted[root];
+        sorted[root] = sorted[child];
+        sorted[child] = temp;
+        root = child;
+    }
+}
+
+/**
+ *  HAL_StatusTypeDef MCP41HVX1_Network_Init(MCP41HVX1_Network *network, MCP41HVX1 *mcpA,
+ *                                           const MCP41HVX1_Calibration *calA, MCP41HVX1 *mcpB,
+ *                                           const MCP41HVX1_Calibration *calB,
+ *                                           MCP41HVX1_Topology topology, uint16_t *sorted)
+ *
+ *  Initialize a two device network and build its sorted table of all code
+ *  pairs. The sort is an in place heap sort so no memory beyond the
+ *  caller supplied table is needed, it is only done once at startup.
+ *
+ *  Returns a HAL_StatusTypeDef indicating success or failure.
+ */
+HAL_StatusTypeDef
+MCP41HVX1_Network_Init (MCP41HVX1_Network *network,
+                        MCP41HVX1 *mcpA,
+                        const MCP41HVX1_Calibration *calA,
+                        MCP41HVX1 *mcpB,
+                        const MCP41HVX1_Calibration *calB,
+                        MCP41HVX1_Topology topology,
+                        uint16_t *sorted)
+{
+    if (mcpA->bus != mcpB->bus || mcpA->transport != mcpB->transport || sorted == NULL)
+    {
+        return HAL_ERROR;
+    }
+
+    network->mcp[0] = mcpA;
+    network->mcp[1] = mcpB;
+    network->topology = topology;
+    network->sorted = sorted;
+
+    _network_calibrate (network->resistance[0], calA);
+    _network_calibrate (network->resistance[1], calB);
+
+    for (uint32_t i = 0; i < MCP_NETWORK_COMBINATIONS; i++)
+        sorted[i] = (uint16_t)i;
+
+    for (uint32_t i = MCP_NETWORK_COMBINATIONS / 2; i > 0; i--)
+        _network_sift (network, i - 1, MCP_NETWORK_COMBINATIONS);
+
+    for (uint32_t end = MCP_NETWORK_COMBINATIONS - 1; end > 0; end--)
+    {
+        uint16_t temp = sorted[0];
+        sorted[0] = sorted[end];
+        sorted[end] = temp;
+        _network_sift (network, 0, end);
+    }
+
+    return HAL_OK;
+}
+
+uint32_t
+MCP41HVX1_Network_Resistance (MCP41HVX1_Network *network, uint16_t pair)
+{
+    uint32_t a = network->resistance[0][MCP_NETWORK_CODE_A (pair)];
+    uint32_t b = network->resistance[1][MCP_NETWORK_CODE_B (pair)];
+
+    if (network->topology == NETWORK_SERIES)
+        return a + b;
+
+    if (a + b == 0)
+        return 0;
+
+    return (uint32_t)(((uint64_t)a * b + (a + b) / 2) / (a + b));
+}
+
+/**
+ *  uint16_t MCP41HVX1_Network_Solve(MCP41HVX1_Network *network, uint32_t milliohms)
+ *
+ *  Find the code pair whose network resistance is closest to the requested
+ *  resistance with a binary search of the sorted table, at most 17 probes.
+ *
+ *  Returns the code pair, see MCP_NETWORK_CODE_A and MCP_NETWORK_CODE_B.
+ */
+uint16_t
+MCP41HVX1_Network_Solve (MCP41HVX1_Network *network, uint32_t milliohms)
+{
+    const uint16_t *sorted = network->sorted;
+    uint32_t low = 0;
+    uint32_t high = MCP_NETWORK_COMBINATIONS;
+
+    // First entry with a resistance not below the request
+    while (low < high)
+    {
+        uint32_t mid = low + (high - low) / 2;
+        if (MCP41HVX1_Network_Resistance (network, sorted[mid]) < milliohms)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    if (low == MCP_NETWORK_COMBINATIONS)
+        return sorted[low - 1];
+
+    if (low == 0)
+        return sorted[0];
+
+    // Pick whichever neighbour is closer
+    uint32_t above = MCP41HVX1_Network_Resistance (network, sorted[low]) - milliohms;
+    uint32_t below = milliohms - MCP41HVX1_Network_Resistance (network, sorted[low - 1]);
+
+    return (below < above) ? sorted[low - 1] : sorted[low];
+}
+
+HAL_StatusTypeDef
+MCP41HVX1_Network_Set_Resistance (MCP41HVX1_Network *network, uint32_t milliohms)
+{
+    uint16_t pair = MCP41HVX1_Network_Solve (network, milliohms);
+    uint8_t codes[2] = { MCP_NETWORK_CODE_A (pair), MCP_NETWORK_CODE_B (pair) };
+
+    // Both devices are updated in one burst on their shared bus
+    return MCP41HVX1_Set_Resistance_Code_Multi (network->mcp, codes, 2);
+}
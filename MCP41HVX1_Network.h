@@ -0,0 +1,66 @@
+/**
+ *      MCP41HVX1 STM32F7 SPI Driver - Series/Parallel Pot Networks
+ *
+ *      Author:     Ethan Garnier
+ *      Date:       2025
+ */
+#ifndef MCP41HVX1_NETWORK_H
+#define MCP41HVX1_NETWORK_H
+
+#include "MCP41HVX1.h"
+
+// Number of code pairs a two device network can be set to
+#define MCP_NETWORK_COMBINATIONS ((MCP_FSV + 1) * (MCP_FSV + 1))
+
+// Packing of a code pair into a single 16 bit table entry
+#define MCP_NETWORK_PAIR(__A__, __B__) ((uint16_t)(((__A__) << 8) | (__B__)))
+#define MCP_NETWORK_CODE_A(__PAIR__) ((uint8_t)((__PAIR__) >> 8))
+#define MCP_NETWORK_CODE_B(__PAIR__) ((uint8_t)((__PAIR__) & 0xFF))
+
+/* MCP41HVX1 Network Topology */
+typedef enum
+{
+    NETWORK_SERIES = 0x00,
+    NETWORK_PARALLEL = 0x01,
+} MCP41HVX1_Topology;
+
+/* MCP41HVX1 Device Calibration Struct */
+typedef struct
+{
+    // Measured resistance in milliohms with the wiper at code 0
+    uint32_t atZero;
+
+    // Measured resistance in milliohms with the wiper at code MCP_FSV
+    uint32_t atFull;
+} MCP41HVX1_Calibration;
+
+/* MCP41HVX1 Two Device Network Struct */
+typedef struct
+{
+    // The two devices making up the network, they must share an SPI handle
+    MCP41HVX1 *mcp[2];
+
+    // How the two devices are wired together
+    MCP41HVX1_Topology topology;
+
+    // Calibrated resistance in milliohms of every code of each device
+    uint32_t resistance[2][MCP_FSV + 1];
+
+    // Every code pair, sorted by network resistance. Supplied by the
+    // caller as it is MCP_NETWORK_COMBINATIONS entries (128 KiB) long.
+    uint16_t *sorted;
+} MCP41HVX1_Network;
+
+HAL_StatusTypeDef MCP41HVX1_Network_Init (MCP41HVX1_Network *network,
+                                          MCP41HVX1 *mcpA,
+                                          const MCP41HVX1_Calibration *calA,
+                                          MCP41HVX1 *mcpB,
+                                          const MCP41HVX1_Calibration *calB,
+                                          MCP41HVX1_Topology topology,
+                                          uint16_t *sorted);
+uint32_t MCP41HVX1_Network_Resistance (MCP41HVX1_Network *network, uint16_t pair);
+uint16_t MCP41HVX1_Network_Solve (MCP41HVX1_Network *network, uint32_t milliohms);
+HAL_StatusTypeDef MCP41HVX1_Network_Set_Resistance (MCP41HVX1_Network *network,
+                                                    uint32_t milliohms);
+
+#endif
@@ -0,0 +1,74 @@
+/**
+ *      MCP41HVX1 STM32F7 SPI Driver - Operating System Abstraction
+ *
+ *      Author:     Ethan Garnier
+ *      Date:       2025
+ */
+#ifndef MCP41HVX1_OS_H
+#define MCP41HVX1_OS_H
+
+#include "MCP41HVX1.h"
+
+// NOTE(Ethan): The few operating system services the asynchronous API
+// (MCP41HVX1_Async.c) needs: signals to wait on with a timeout, a critical
+// section, a worker thread and sleeping. One port is picked at compile
+// time and its source added to the project:
+//
+//      MCP41HVX1_OS_FREERTOS   FreeRTOS on target (MCP41HVX1_Os_FreeRTOS.c),
+//                              needs configSUPPORT_STATIC_ALLOCATION and
+//                              configSUPPORT_DYNAMIC_ALLOCATION
+//      MCP41HVX1_OS_POSIX      pthreads on host (MCP41HVX1_Os_Posix.c)
+//
+//  Without either the driver stays bare metal and nothing here is built.
+
+#if defined(MCP41HVX1_OS_FREERTOS) || defined(MCP41HVX1_OS_POSIX)
+#define MCP41HVX1_OS
+
+// Timeout waiting as long as it takes
+#define MCP_OS_FOREVER 0xFFFFFFFF
+
+#if defined(MCP41HVX1_OS_FREERTOS)
+#include "FreeRTOS.h"
+#include "semphr.h"
+
+/* MCP41HVX1 OS Signal Struct */
+typedef struct
+{
+    StaticSemaphore_t storage;
+    SemaphoreHandle_t handle;
+} MCP41HVX1_Os_Signal;
+#else
+#include "pthread.h"
+
+/* MCP41HVX1 OS Signal Struct */
+typedef struct
+{
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    uint8_t raised;
+} MCP41HVX1_Os_Signal;
+#endif
+
+// Binary signals, raised from threads or interrupts and waited on by one
+// thread at a time. Raising a raised signal does nothing.
+void MCP41HVX1_Os_Signal_Init (MCP41HVX1_Os_Signal *signal);
+void MCP41HVX1_Os_Signal_Raise (MCP41HVX1_Os_Signal *signal);
+HAL_StatusTypeDef MCP41HVX1_Os_Signal_Wait (MCP41HVX1_Os_Signal *signal, uint32_t timeout);
+
+// Critical section usable from threads and interrupts, returning and
+// taking back the state to restore
+uint32_t MCP41HVX1_Os_Critical_Enter (void);
+void MCP41HVX1_Os_Critical_Exit (uint32_t state);
+
+// Start a detached thread, priority and stack size only mean anything on target
+HAL_StatusTypeDef MCP41HVX1_Os_Thread_Start (void (*entry) (void *argument),
+                                             void *argument,
+                                             uint32_t priority,
+                                             uint32_t stackBytes);
+void MCP41HVX1_Os_Sleep (uint32_t ms);
+
+// Give up the core to other threads, fits the MCP_WAIT_YIELD wait strategy
+void MCP41HVX1_Os_Yield (void);
+#endif
+
+#endif
@@ -0,0 +1,118 @@
+/**
+ *      MCP41HVX1 STM32F7 SPI Driver - FreeRTOS Port
+ *
+ *      Author:     Ethan Garnier
+ *      Date:       2025
+ */
+#include "MCP41HVX1_Os.h"
+
+#ifdef MCP41HVX1_OS_FREERTOS
+#include "task.h"
+
+// Milliseconds to ticks, never rounding a non-zero wait down to no wait
+static TickType_t
+_os_ticks (uint32_t ms)
+{
+    if (ms == MCP_OS_FOREVER)
+    {
+        return portMAX_DELAY;
+    }
+
+    TickType_t ticks = pdMS_TO_TICKS (ms);
+    return (ms && ticks == 0) ? 1 : ticks;
+}
+
+void
+MCP41HVX1_Os_Signal_Init (MCP41HVX1_Os_Signal *signal)
+{
+    signal->handle = xSemaphoreCreateBinaryStatic (&signal->storage);
+}
+
+void
+MCP41HVX1_Os_Signal_Raise (MCP41HVX1_Os_Signal *signal)
+{
+    if (xPortIsInsideInterrupt ())
+    {
+        BaseType_t woken = pdFALSE;
+        xSemaphoreGiveFromISR (signal->handle, &woken);
+        portYIELD_FROM_ISR (woken);
+    }
+    else
+    {
+        xSemaphoreGive (signal->handle);
+    }
+}
+
+HAL_StatusTypeDef
+MCP41HVX1_Os_Signal_Wait (MCP41HVX1_Os_Signal *signal, uint32_t timeout)
+{
+    return (xSemaphoreTake (signal->handle, _os_ticks (timeout)) == pdTRUE) ? HAL_OK : HAL_TIMEOUT;
+}
+
+uint32_t
+MCP41HVX1_Os_Critical_Enter (void)
+{
+    // Masks interrupts up to configMAX_SYSCALL_INTERRUPT_PRIORITY, so it
+    // nests and works from tasks and interrupts alike
+    return (uint32_t)portSET_INTERRUPT_MASK_FROM_ISR ();
+}
+
+void
+MCP41HVX1_Os_Critical_Exit (uint32_t state)
+{
+    portCLEAR_INTERRUPT_MASK_FROM_ISR ((UBaseType_t)state);
+}
+
+/* FreeRTOS task entry, a task must never return */
+typedef struct
+{
+    void (*entry) (void *argument);
+    void *argument;
+} MCP41HVX1_Os_Start;
+
+static void
+_os_task (void *start)
+{
+    MCP41HVX1_Os_Start *task = (MCP41HVX1_Os_Start *)start;
+    task->entry (task->argument);
+    vPortFree (task);
+    vTaskDelete (NULL);
+}
+
+HAL_StatusTypeDef
+MCP41HVX1_Os_Thread_Start (void (*entry) (void *argument),
+                           void *argument,
+                           uint32_t priority,
+                           uint32_t stackBytes)
+{
+    MCP41HVX1_Os_Start *task = (MCP41HVX1_Os_Start *)pvPortMalloc (sizeof (MCP41HVX1_Os_Start));
+    if (task == NULL)
+    {
+        return HAL_ERROR;
+    }
+
+    task->entry = entry;
+    task->argument = argument;
+
+    configSTACK_DEPTH_TYPE depth = (configSTACK_DEPTH_TYPE)(stackBytes / sizeof (StackType_t));
+    if (xTaskCreate (_os_task, "mcp41hvx1", depth, task, (UBaseType_t)priority, NULL) != pdPASS)
+    {
+        vPortFree (task);
+        return HAL_ERROR;
+    }
+
+    return HAL_OK;
+}
+
+void
+MCP41HVX1_Os_Sleep (uint32_t ms)
+{
+    vTaskDelay (_os_ticks (ms));
+}
+
+void
+MCP41HVX1_Os_Yield (void)
+{
+    taskYIELD ();
+}
+#endif
@@ -0,0 +1,138 @@
+/**
+ *      MCP41HVX1 STM32F7 SPI Driver - POSIX Threads Port
+ *
+ *      Author:     Ethan Garnier
+ *      Date:       2025
+ */
+#define _POSIX_C_SOURCE 200809L
+#include "MCP41HVX1_Os.h"
+
+#ifdef MCP41HVX1_OS_POSIX
+#include "sched.h"
+#include "stdlib.h"
+#include "time.h"
+
+// Host threads preempt each other at any point, so the critical section
+// is one lock shared by everything. Interrupts don't exist on a host.
+static pthread_mutex_t _os_critical = PTHREAD_MUTEX_INITIALIZER;
+
+void
+MCP41HVX1_Os_Signal_Init (MCP41HVX1_Os_Signal *signal)
+{
+    pthread_mutex_init (&signal->mutex, NULL);
+    pthread_cond_init (&signal->cond, NULL);
+    signal->raised = 0;
+}
+
+void
+MCP41HVX1_Os_Signal_Raise (MCP41HVX1_Os_Signal *signal)
+{
+    pthread_mutex_lock (&signal->mutex);
+    signal->raised = 1;
+    pthread_cond_signal (&signal->cond);
+    pthread_mutex_unlock (&signal->mutex);
+}
+
+HAL_StatusTypeDef
+MCP41HVX1_Os_Signal_Wait (MCP41HVX1_Os_Signal *signal, uint32_t timeout)
+{
+    struct timespec deadline;
+    clock_gettime (CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout / 1000;
+    deadline.tv_nsec += (long)(timeout % 1000) * 1000000;
+    if (deadline.tv_nsec >= 1000000000)
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000;
+    }
+
+    pthread_mutex_lock (&signal->mutex);
+
+    int error = 0;
+    while (!signal->raised && error == 0)
+    {
+        if (timeout == MCP_OS_FOREVER)
+            error = pthread_cond_wait (&signal->cond, &signal->mutex);
+        else
+            error = pthread_cond_timedwait (&signal->cond, &signal->mutex, &deadline);
+    }
+
+    uint8_t raised = signal->raised;
+    signal->raised = 0;
+    pthread_mutex_unlock (&signal->mutex);
+
+    return raised ? HAL_OK : HAL_TIMEOUT;
+}
+
+uint32_t
+MCP41HVX1_Os_Critical_Enter (void)
+{
+    pthread_mutex_lock (&_os_critical);
+    return 0;
+}
+
+void
+MCP41HVX1_Os_Critical_Exit (uint32_t state)
+{
+    (void)state;
+    pthread_mutex_unlock (&_os_critical);
+}
+
+/* Thread entry, adapting to the pthread start routine signature */
+typedef struct
+{
+    void (*entry) (void *argument);
+    void *argument;
+} MCP41HVX1_Os_Start;
+
+static void *
+_os_thread (void *start)
+{
+    MCP41HVX1_Os_Start task = *(MCP41HVX1_Os_Start *)start;
+    free (start);
+    task.entry (task.argument);
+    return NULL;
+}
+
+HAL_StatusTypeDef
+MCP41HVX1_Os_Thread_Start (void (*entry) (void *argument),
+                           void *argument,
+                           uint32_t priority,
+                           uint32_t stackBytes)
+{
+    (void)priority;
+    (void)stackBytes;
+
+    MCP41HVX1_Os_Start *task = (MCP41HVX1_Os_Start *)malloc (sizeof (MCP41HVX1_Os_Start));
+    if (task == NULL)
+    {
+        return HAL_ERROR;
+    }
+
+    task->entry = entry;
+    task->argument = argument;
+
+    pthread_t thread;
+    if (pthread_create (&thread, NULL, _os_thread, task) != 0)
+    {
+        free (task);
+        return HAL_ERROR;
+    }
+
+    pthread_detach (thread);
+    return HAL_OK;
+}
+
+void
+MCP41HVX1_Os_Sleep (uint32_t ms)
+{
+    struct timespec delay = { (time_t)(ms / 1000), (long)(ms % 1000) * 1000000 };
+    nanosleep (&delay, NULL);
+}
+
+void
+MCP41HVX1_Os_Yield (void)
+{
+    sched_yield ();
+}
+#endif
@@ -0,0 +1,110 @@
+/**
+ *      MCP41HVX1 STM32F7 SPI Driver - Slew Rate Limited Ramps
+ *
+ *      Author:     Ethan Garnier
+ *      Date:       2025
+ */
+#include "MCP41HVX1_Ramp.h"
+
+/**
+ *  HAL_StatusTypeDef MCP41HVX1_Ramp_Init(MCP41HVX1_Ramp *ramp, MCP41HVX1 *mcp,
+ *                                        uint8_t code, uint8_t maxSteps)
+ *
+ *  Initialize a ramp engine for the device. The wiper is written to code
+ *  with an absolute write so the engine starts from a known state, after
+ *  which all movement is done with increment/decrement commands. Codes
+ *  past the device's full scale are clamped to it.
+ *
+ *  Returns a HAL_StatusTypeDef indicating success or failure.
+ */
+HAL_StatusTypeDef
+MCP41HVX1_Ramp_Init (MCP41HVX1_Ramp *ramp, MCP41HVX1 *mcp, uint8_t code, uint8_t maxSteps)
+{
+    if (maxSteps == 0)
+    {
+        return HAL_ERROR;
+    }
+
+    // The wiper stops at full scale, a code past it would leave the
+    // tracked position out of step with the device
+    code = __MCP_CLAMP_CODE (mcp, code);
+
+    ramp->mcp = mcp;
+    ramp->target = code;
+    ramp->code = code;
+    ramp->start = code;
+    ramp->maxSteps = maxSteps;
+
+    return MCP41HVX1_Set_Resistance_Code (mcp, code);
+}
+
+void
+MCP41HVX1_Ramp_Set_Target (MCP41HVX1_Ramp *ramp, uint8_t target)
+{
+    // The wiper keeps moving from wherever it currently is, only
+    // the progress reference is moved to the current position
+    ramp->start = ramp->code;
+    ramp->target = __MCP_CLAMP_CODE (ramp->mcp, target);
+}
+
+/**
+ *  HAL_StatusTypeDef MCP41HVX1_Ramp_Tick(MCP41HVX1_Ramp *ramp)
+ *
+ *  Move the wiper up to maxSteps codes towards the target. Intended to be
+ *  called from a timer interrupt, all steps of a tick are sent as a batch
+ *  of increment or decrement commands in a single chip select frame.
+ *
+ *  Returns a HAL_StatusTypeDef indicating success or failure. HAL_BUSY is
+ *  returned if the SPI bus was locked, the steps are retried next tick.
+ */
+HAL_StatusTypeDef
+MCP41HVX1_Ramp_Tick (MCP41HVX1_Ramp *ramp)
+{
+    uint8_t target = ramp->target;
+    uint8_t code = ramp->code;
+
+    if (code == target)
+    {
+        return HAL_OK;
+    }
+
+    MCP41HVX1_Wiper_Command cmd = (target > code) ? INCR_WIPER : DECR_WIPER;
+    uint8_t steps = (target > code) ? (target - code) : (code - target);
+    if (steps > ramp->maxSteps)
+        steps = ramp->maxSteps;
+
+    uint8_t next = (cmd == INCR_WIPER) ? (code + steps) : (code - steps);
+
+    HAL_StatusTypeDef status = MCP41HVX1_Move_Wiper_N (ramp->mcp, cmd, steps);
+    if (status == HAL_ERROR)
+    {
+        // Some of the steps may have been dropped, resynchronize
+        // with an absolute write. The jump is at most maxSteps codes.
+        status = MCP41HVX1_Set_Resistance_Code (ramp->mcp, next);
+    }
+
+    if (status == HAL_OK)
+        ramp->code = next;
+
+    return status;
+}
+
+uint8_t
+MCP41HVX1_Ramp_Progress (MCP41HVX1_Ramp *ramp)
+{
+    uint8_t start = ramp->start;
+    uint8_t target = ramp->target;
+    uint8_t code = ramp->code;
+
+    uint16_t total = (target > start) ? (target - start) : (start - target);
+    uint16_t done = (code > start) ? (code - start) : (start - code);
+
+    // Percentage of the current leg completed
+    return (total == 0) ? 100 : (uint8_t)((done * 100) / total);
+}
+
+uint8_t
+MCP41HVX1_Ramp_Done (MCP41HVX1_Ramp *ramp)
+{
+    return ramp->code == ramp->target;
+}
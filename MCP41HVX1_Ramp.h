@@ -0,0 +1,40 @@
+/**
+ *      MCP41HVX1 STM32F7 SPI Driver - Slew Rate Limited Ramps
+ *
+ *      Author:     Ethan Garnier
+ *      Date:       2025
+ */
+#ifndef MCP41HVX1_RAMP_H
+#define MCP41HVX1_RAMP_H
+
+#include "MCP41HVX1.h"
+
+/* MCP41HVX1 Ramp Engine Struct */
+typedef struct
+{
+    // Device being ramped
+    MCP41HVX1 *mcp;
+
+    // Code the ramp is heading towards, may be changed at any time
+    volatile uint8_t target;
+
+    // Code the wiper currently holds
+    volatile uint8_t code;
+
+    // Code the current leg of the ramp started from, used for progress
+    uint8_t start;
+
+    // Maximum number of wiper steps taken per tick
+    uint8_t maxSteps;
+} MCP41HVX1_Ramp;
+
+HAL_StatusTypeDef MCP41HVX1_Ramp_Init (MCP41HVX1_Ramp *ramp,
+                                       MCP41HVX1 *mcp,
+                                       uint8_t code,
+                                       uint8_t maxSteps);
+void MCP41HVX1_Ramp_Set_Target (MCP41HVX1_Ramp *ramp, uint8_t target);
+HAL_StatusTypeDef MCP41HVX1_Ramp_Tick (MCP41HVX1_Ramp *ramp);
+uint8_t MCP41HVX1_Ramp_Progress (MCP41HVX1_Ramp *ramp);
+uint8_t MCP41HVX1_Ramp_Done (MCP41HVX1_Ramp *ramp);
+
+#endif
@@ -0,0 +1,317 @@
+/**
+ *      MCP41HVX1 STM32F7 SPI Driver - Bus Transaction Scheduler
+ *
+ *      Author:     Ethan Garnier
+ *      Date:       2025
+ */
+#include "MCP41HVX1_Os.h"
+#include "MCP41HVX1_Sched.h"
+#include "MCP41HVX1_Transport.h"
+
+// The queue is shared with submissions from interrupts, and with other
+// threads under an operating system (see MCP41HVX1_Os.h)
+#ifdef MCP41HVX1_OS
+#define __SCHED_ENTER() uint32_t primask = MCP41HVX1_Os_Critical_Enter ()
+#define __SCHED_EXIT() MCP41HVX1_Os_Critical_Exit (primask)
+#else
+#define __SCHED_ENTER()                                                                            \
+    uint32_t primask = __get_PRIMASK ();                                                           \
+    __disable_irq ()
+#define __SCHED_EXIT() __set_PRIMASK (primask)
+#endif
+
+// Tick comparison that survives HAL_GetTick wrapping around
+#define __SCHED_BEFORE(__A__, __B__) ((int32_t)((__A__) - (__B__)) < 0)
+
+HAL_StatusTypeDef
+MCP41HVX1_Sched_Init (MCP41HVX1_Sched *sched, MCP41HVX1 *mcp)
+{
+    if (mcp == NULL)
+    {
+        return HAL_ERROR;
+    }
+
+    sched->bus = mcp->bus;
+    sched->transport = mcp->transport;
+    sched->head = NULL;
+    sched->idle = NULL;
+    sched->context = NULL;
+    sched->completed = 0;
+    sched->missed = 0;
+    sched->failed = 0;
+
+    return HAL_OK;
+}
+
+/**
+ *  void MCP41HVX1_Txn_Write_Register(MCP41HVX1_Txn *txn, MCP41HVX1 *mcp, uint8_t address,
+ *                                    uint8_t value, uint8_t priority, uint32_t timeout)
+ *
+ *  Set up a transaction writing value to one of the device's registers
+ *  (0x00 wiper, 0x04 TCON), due timeout milliseconds from now.
+ */
+void
+MCP41HVX1_Txn_Write_Register (MCP41HVX1_Txn *txn,
+                              MCP41HVX1 *mcp,
+                              uint8_t address,
+                              uint8_t value,
+                              uint8_t priority,
+                              uint32_t timeout)
+{
+    // The address sits in the upper nibble of the command byte
+    txn->mcp = mcp;
+    txn->tx[0] = (uint8_t)(address << 4);
+    txn->tx[1] = value;
+    txn->len = 2;
+    txn->priority = priority;
+    txn->deadline = HAL_GetTick () + timeout;
+    txn->state = MCP_TXN_IDLE;
+    txn->done = NULL;
+    txn->context = NULL;
+}
+
+/**
+ *  void MCP41HVX1_Txn_Read_Register(MCP41HVX1_Txn *txn, MCP41HVX1 *mcp, uint8_t address,
+ *                                   uint8_t priority, uint32_t timeout)
+ *
+ *  Set up a transaction reading one of the device's registers, due
+ *  timeout milliseconds from now. Once done the value read is in rx[1].
+ */
+void
+MCP41HVX1_Txn_Read_Register (MCP41HVX1_Txn *txn,
+                             MCP41HVX1 *mcp,
+                             uint8_t address,
+                             uint8_t priority,
+                             uint32_t timeout)
+{
+    txn->mcp = mcp;
+    txn->tx[0] = (uint8_t)(address << 4) | 0x0C;
+    txn->tx[1] = 0x00;
+    txn->len = 2;
+    txn->priority = priority;
+    txn->deadline = HAL_GetTick () + timeout;
+    txn->state = MCP_TXN_IDLE;
+    txn->done = NULL;
+    txn->context = NULL;
+}
+
+/**
+ *  void MCP41HVX1_Txn_Write(MCP41HVX1_Txn *txn, MCP41HVX1 *mcp, uint8_t code,
+ *                           uint8_t priority, uint32_t timeout)
+ *
+ *  Set up a transaction writing a resistance code to the device, due
+ *  timeout milliseconds from now.
+ */
+void
+MCP41HVX1_Txn_Write (MCP41HVX1_Txn *txn,
+                     MCP41HVX1 *mcp,
+                     uint8_t code,
+                     uint8_t priority,
+                     uint32_t timeout)
+{
+    // Codes past the full scale value of the fitted part are clamped to it
+    code = __MCP_CLAMP_CODE (mcp, code);
+
+    MCP41HVX1_Txn_Write_Register (txn, mcp, 0x00, code, priority, timeout);
+}
+
+/**
+ *  void MCP41HVX1_Txn_Read(MCP41HVX1_Txn *txn, MCP41HVX1 *mcp, uint8_t priority,
+ *                          uint32_t timeout)
+ *
+ *  Set up a transaction reading the device's resistance code, due timeout
+ *  milliseconds from now. Once done the code read is in rx[1].
+ */
+void
+MCP41HVX1_Txn_Read (MCP41HVX1_Txn *txn, MCP41HVX1 *mcp, uint8_t priority, uint32_t timeout)
+{
+    MCP41HVX1_Txn_Read_Register (txn, mcp, 0x00, priority, timeout);
+}
+
+/**
+ *  HAL_StatusTypeDef MCP41HVX1_Sched_Submit(MCP41HVX1_Sched *sched, MCP41HVX1_Txn *txn)
+ *
+ *  Queue a transaction behind every transaction of a more urgent class
+ *  and every one of its own class due no later than it. The transaction
+ *  must not be touched again until it is done or cancelled.
+ *
+ *  Returns a HAL_StatusTypeDef indicating success or failure.
+ */
+HAL_StatusTypeDef
+MCP41HVX1_Sched_Submit (MCP41HVX1_Sched *sched, MCP41HVX1_Txn *txn)
+{
+    if (txn->mcp->bus != sched->bus || txn->mcp->transport != sched->transport || txn->len == 0
+        || txn->len > MCP_TXN_MAX_LEN)
+    {
+        return HAL_ERROR;
+    }
+
+    __SCHED_ENTER ();
+
+    if (__MCP_TXN_PENDING (txn))
+    {
+        __SCHED_EXIT ();
+        return HAL_BUSY;
+    }
+
+    MCP41HVX1_Txn **link = &sched->head;
+    while (*link
+           && ((*link)->priority < txn->priority
+               || ((*link)->priority == txn->priority
+                   && !__SCHED_BEFORE (txn->deadline, (*link)->deadline))))
+    {
+        link = &(*link)->next;
+    }
+
+    txn->late = 0;
+    txn->state = MCP_TXN_QUEUED;
+    txn->next = *link;
+    *link = txn;
+
+    __SCHED_EXIT ();
+    return HAL_OK;
+}
+
+// Take a transaction off the queue, with the queue already entered
+static uint8_t
+_sched_unlink (MCP41HVX1_Sched *sched, MCP41HVX1_Txn *txn)
+{
+    for (MCP41HVX1_Txn **link = &sched->head; *link; link = &(*link)->next)
+    {
+        if (*link == txn)
+        {
+            *link = txn->next;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ *  HAL_StatusTypeDef MCP41HVX1_Sched_Cancel(MCP41HVX1_Sched *sched, MCP41HVX1_Txn *txn)
+ *
+ *  Take a queued transaction off the queue before it runs.
+ *
+ *  Returns HAL_BUSY if the transaction is already running, it can only
+ *  be waited for. HAL_ERROR if it isn't queued, otherwise HAL_OK.
+ */
+HAL_StatusTypeDef
+MCP41HVX1_Sched_Cancel (MCP41HVX1_Sched *sched, MCP41HVX1_Txn *txn)
+{
+    HAL_StatusTypeDef status = HAL_ERROR;
+    __SCHED_ENTER ();
+
+    if (txn->state == MCP_TXN_RUNNING)
+    {
+        status = HAL_BUSY;
+    }
+    else if (_sched_unlink (sched, txn))
+    {
+        txn->state = MCP_TXN_IDLE;
+        status = HAL_OK;
+    }
+
+    __SCHED_EXIT ();
+    return status;
+}
+
+static HAL_StatusTypeDef
+_sched_execute (MCP41HVX1_Txn *txn)
+{
+    MCP41HVX1 *mcp = txn->mcp;
+    HAL_StatusTypeDef status = __MCP_ACQUIRE (mcp);
+    if (status != HAL_OK)
+    {
+        return status;
+    }
+
+    __MCP_XPORT_SELECT (mcp);
+    status = __MCP_TRANSFER (mcp, txn->tx, txn->rx, txn->len);
+    __MCP_XPORT_UNSELECT (mcp);
+    __MCP_RELEASE (mcp);
+
+    if (status != HAL_OK)
+        return status;
+
+    // If CMDERR (bit 7) is low, then an error has occured
+    return (txn->rx[0] & 0x02) ? HAL_OK : HAL_ERROR;
+}
+
+/**
+ *  HAL_StatusTypeDef MCP41HVX1_Sched_Run(MCP41HVX1_Sched *sched)
+ *
+ *  Run queued transactions until the queue is empty, always taking the
+ *  head so anything more urgent submitted meanwhile goes next. Once the
+ *  queue is empty the idle hook gets a chance to queue background work,
+ *  which runs on the next call.
+ *
+ *  Returns HAL_BUSY if the bus was held by something outside the
+ *  scheduler, the transaction stays queued for the next call. Otherwise
+ *  HAL_OK, failed transactions report through their own status.
+ */
+HAL_StatusTypeDef
+MCP41HVX1_Sched_Run (MCP41HVX1_Sched *sched)
+{
+    for (;;)
+    {
+        // Marked running before it goes on the bus, from then on it can no
+        // longer be cancelled or submitted again
+        MCP41HVX1_Txn *txn;
+        {
+            __SCHED_ENTER ();
+            txn = sched->head;
+            if (txn)
+                txn->state = MCP_TXN_RUNNING;
+            __SCHED_EXIT ();
+        }
+
+        if (txn == NULL)
+            break;
+
+        HAL_StatusTypeDef status = _sched_execute (txn);
+
+        // Dequeue only once it has run, a transaction submitted meanwhile
+        // may have been queued ahead of it
+        {
+            __SCHED_ENTER ();
+            if (status == HAL_BUSY)
+                txn->state = MCP_TXN_QUEUED;
+            else
+                _sched_unlink (sched, txn);
+            __SCHED_EXIT ();
+        }
+
+        if (status == HAL_BUSY)
+        {
+            return HAL_BUSY;
+        }
+
+        if (__SCHED_BEFORE (txn->deadline, HAL_GetTick ()))
+        {
+            txn->late = 1;
+            sched->missed++;
+        }
+
+        if (status == HAL_OK)
+            sched->completed++;
+        else
+            sched->failed++;
+
+        txn->status = status;
+        txn->state = (status == HAL_OK) ? MCP_TXN_DONE : MCP_TXN_FAILED;
+        if (txn->done)
+            txn->done (txn);
+    }
+
+    if (sched->idle)
+        sched->idle (sched);
+
+    return HAL_OK;
+}
+
+uint8_t
+MCP41HVX1_Sched_Idle (MCP41HVX1_Sched *sched)
+{
+    return sched->head == NULL;
+}
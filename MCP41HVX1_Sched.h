@@ -0,0 +1,115 @@
+/**
+ *      MCP41HVX1 STM32F7 SPI Driver - Bus Transaction Scheduler
+ *
+ *      Author:     Ethan Garnier
+ *      Date:       2025
+ */
+#ifndef MCP41HVX1_SCHED_H
+#define MCP41HVX1_SCHED_H
+
+#include "MCP41HVX1.h"
+
+// NOTE(Ethan): Commands issued directly contend for the bus through its
+// lock, so whoever gets there first wins and an urgent setpoint can be
+// turned away with HAL_BUSY by a diagnostics read. The scheduler instead
+// queues transactions for every device on one bus and runs them in order
+// of priority class, then earliest deadline first within a class. A
+// transaction run after its deadline still runs but is counted as missed.
+//
+//  Transactions may be submitted from interrupts. MCP41HVX1_Sched_Run is
+//  called from one context only, typically the main loop or a low
+//  priority task, and the scheduler should be the only user of the bus.
+
+/* MCP41HVX1 Transaction Priority Classes */
+#define MCP_PRIORITY_URGENT 0
+#define MCP_PRIORITY_NORMAL 1
+#define MCP_PRIORITY_BACKGROUND 2
+
+/* MCP41HVX1 Transaction States */
+#define MCP_TXN_IDLE 0
+#define MCP_TXN_QUEUED 1
+#define MCP_TXN_RUNNING 2
+#define MCP_TXN_DONE 3
+#define MCP_TXN_FAILED 4
+
+// Whether a transaction is still owned by the scheduler, queued or on the bus
+#define __MCP_TXN_PENDING(__TXN__)                                                                 \
+    ((__TXN__)->state == MCP_TXN_QUEUED || (__TXN__)->state == MCP_TXN_RUNNING)
+
+// Most bytes a transaction exchanges within its chip select frame
+#define MCP_TXN_MAX_LEN 4
+
+/* MCP41HVX1 Scheduled Transaction Struct */
+typedef struct MCP41HVX1_Txn
+{
+    // Device the transaction goes to
+    MCP41HVX1 *mcp;
+
+    // Bytes sent and received within a single chip select frame
+    uint8_t tx[MCP_TXN_MAX_LEN];
+    uint8_t rx[MCP_TXN_MAX_LEN];
+    uint8_t len;
+
+    // Priority class and HAL_GetTick value the transaction is due by
+    uint8_t priority;
+    uint32_t deadline;
+
+    // Progress and outcome, and whether it ran past its deadline
+    volatile uint8_t state;
+    HAL_StatusTypeDef status;
+    uint8_t late;
+
+    // Called from MCP41HVX1_Sched_Run once the transaction has run, may be
+    // NULL. Cleared along with context by the MCP41HVX1_Txn helpers, so
+    // set them afterwards.
+    void (*done) (struct MCP41HVX1_Txn *txn);
+    void *context;
+
+    struct MCP41HVX1_Txn *next;
+} MCP41HVX1_Txn;
+
+/* MCP41HVX1 Bus Scheduler Struct */
+typedef struct MCP41HVX1_Sched
+{
+    // Bus context and transport every device submitted must share
+    void *bus;
+    const struct MCP41HVX1_Transport *transport;
+
+    // Queued transactions, in the order they will run
+    MCP41HVX1_Txn *head;
+
+    // Called from MCP41HVX1_Sched_Run whenever the queue runs dry, may
+    // queue background work for the idle bus. May be NULL.
+    void (*idle) (struct MCP41HVX1_Sched *sched);
+    void *context;
+
+    // Transactions run, run past their deadline and failed
+    uint32_t completed;
+    uint32_t missed;
+    uint32_t failed;
+} MCP41HVX1_Sched;
+
+HAL_StatusTypeDef MCP41HVX1_Sched_Init (MCP41HVX1_Sched *sched, MCP41HVX1 *mcp);
+void MCP41HVX1_Txn_Write (MCP41HVX1_Txn *txn,
+                          MCP41HVX1 *mcp,
+                          uint8_t code,
+                          uint8_t priority,
+                          uint32_t timeout);
+void MCP41HVX1_Txn_Read (MCP41HVX1_Txn *txn, MCP41HVX1 *mcp, uint8_t priority, uint32_t timeout);
+void MCP41HVX1_Txn_Write_Register (MCP41HVX1_Txn *txn,
+                                   MCP41HVX1 *mcp,
+                                   uint8_t address,
+                                   uint8_t value,
+                                   uint8_t priority,
+                                   uint32_t timeout);
+void MCP41HVX1_Txn_Read_Register (MCP41HVX1_Txn *txn,
+                                  MCP41HVX1 *mcp,
+                                  uint8_t address,
+                                  uint8_t priority,
+                                  uint32_t timeout);
+HAL_StatusTypeDef MCP41HVX1_Sched_Submit (MCP41HVX1_Sched *sched, MCP41HVX1_Txn *txn);
+HAL_StatusTypeDef MCP41HVX1_Sched_Cancel (MCP41HVX1_Sched *sched, MCP41HVX1_Txn *txn);
+HAL_StatusTypeDef MCP41HVX1_Sched_Run (MCP41HVX1_Sched *sched);
+uint8_t MCP41HVX1_Sched_Idle (MCP41HVX1_Sched *sched);
+
+#endif
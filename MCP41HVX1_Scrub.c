@@ -0,0 +1,193 @@
+/**
+ *      MCP41HVX1 STM32F7 SPI Driver - Background Readback Scrubbing
+ *
+ *      Author:     Ethan Garnier
+ *      Date:       2025
+ */
+#include "MCP41HVX1_Scrub.h"
+
+// Deadline given to scrub reads and corrections, in milliseconds. Reads
+// are background work whose deadline hardly matters, corrections should
+// go out soon but never ahead of foreground updates.
+#define MCP_SCRUB_READ_TIMEOUT 1000
+#define MCP_SCRUB_FIX_TIMEOUT 10
+
+static void
+_scrub_done (MCP41HVX1_Txn *txn)
+{
+    MCP41HVX1_Scrub *scrub = (MCP41HVX1_Scrub *)txn->context;
+    uint8_t i = scrub->cursor;
+    uint8_t address = scrub->address;
+
+    // Move on to the device's other register, or the next device
+    if (address == 0x00)
+    {
+        scrub->address = 0x04;
+    }
+    else
+    {
+        scrub->address = 0x00;
+        scrub->cursor = (uint8_t)((i + 1) % scrub->count);
+    }
+
+    // A failed read tells nothing about the device, try again next round
+    if (txn->status != HAL_OK || !scrub->valid[i])
+        return;
+
+    scrub->reads++;
+
+    uint8_t expected = (address == 0x00) ? scrub->wiper[i] : scrub->tcon[i];
+    if (txn->rx[1] == expected)
+        return;
+
+    scrub->mismatches++;
+
+    // Only one correction is ever queued, any other mismatch is caught
+    // again on the next round
+    if (__MCP_TXN_PENDING (&scrub->fix))
+        return;
+
+    MCP41HVX1_Txn_Write_Register (&scrub->fix,
+                                  scrub->device[i],
+                                  address,
+                                  expected,
+                                  MCP_PRIORITY_NORMAL,
+                                  MCP_SCRUB_FIX_TIMEOUT);
+    if (MCP41HVX1_Sched_Submit (scrub->sched, &scrub->fix) == HAL_OK)
+        scrub->corrections++;
+}
+
+static void
+_scrub_idle (MCP41HVX1_Sched *sched)
+{
+    MCP41HVX1_Scrub *scrub = (MCP41HVX1_Scrub *)sched->context;
+    if (__MCP_TXN_PENDING (&scrub->read))
+    {
+        return;
+    }
+
+    // Every millisecond passed grants budget percent of it to scrubbing,
+    // unspent time is kept for a few reads at most. Worked out in 64 bits,
+    // a long gap between idle calls would wrap the grant in 32.
+    uint32_t now = HAL_GetTick ();
+    uint64_t grant = (uint64_t)(now - scrub->lastTick) * 10 * scrub->budget;
+    uint32_t limit = scrub->readUs * 4;
+    scrub->lastTick = now;
+    scrub->credit = (scrub->credit + grant >= limit) ? limit : (uint32_t)(scrub->credit + grant);
+    if (scrub->credit < scrub->readUs)
+    {
+        return;
+    }
+
+    // Skip over devices whose shadows haven't been set
+    for (uint8_t n = 0; n < scrub->count && !scrub->valid[scrub->cursor]; n++)
+    {
+        scrub->cursor = (uint8_t)((scrub->cursor + 1) % scrub->count);
+        scrub->address = 0x00;
+    }
+
+    if (!scrub->valid[scrub->cursor])
+    {
+        return;
+    }
+
+    MCP41HVX1_Txn_Read_Register (&scrub->read,
+                                 scrub->device[scrub->cursor],
+                                 scrub->address,
+                                 MCP_PRIORITY_BACKGROUND,
+                                 MCP_SCRUB_READ_TIMEOUT);
+    scrub->read.done = _scrub_done;
+    scrub->read.context = scrub;
+
+    if (MCP41HVX1_Sched_Submit (sched, &scrub->read) == HAL_OK)
+        scrub->credit -= scrub->readUs;
+}
+
+/**
+ *  HAL_StatusTypeDef MCP41HVX1_Scrub_Init(MCP41HVX1_Scrub *scrub, MCP41HVX1_Sched *sched,
+ *                                         MCP41HVX1 *const *devices, uint8_t count,
+ *                                         uint8_t budget)
+ *
+ *  Start scrubbing count devices on the scheduler's bus, using at most
+ *  budget percent of bus time. The scrubber becomes the scheduler's idle
+ *  hook. Nothing is read back from a device until its shadow values have
+ *  been set with MCP41HVX1_Scrub_Set_Shadow.
+ *
+ *  Returns a HAL_StatusTypeDef indicating success or failure.
+ */
+HAL_StatusTypeDef
+MCP41HVX1_Scrub_Init (MCP41HVX1_Scrub *scrub,
+                      MCP41HVX1_Sched *sched,
+                      MCP41HVX1 *const *devices,
+                      uint8_t count,
+                      uint8_t budget)
+{
+    if (count == 0 || count > MCP_SCRUB_MAX || budget > 100)
+    {
+        return HAL_ERROR;
+    }
+
+    scrub->sched = sched;
+    scrub->count = count;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        scrub->device[i] = devices[i];
+        scrub->valid[i] = 0;
+    }
+
+    // A read is 16 clocks, at the slowest SCK of the devices watched.
+    // Devices keeping the handle's own SCK are assumed to run at 1 MHz.
+    uint32_t slowest = MCP_SCK_MAX_HZ;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        uint32_t hz = devices[i]->maxSckHz ? devices[i]->maxSckHz : 1000000;
+        if (hz < slowest)
+            slowest = hz;
+    }
+
+    scrub->readUs = MCP_SCRUB_OVERHEAD_US + (16000000 + slowest - 1) / slowest;
+    scrub->budget = budget;
+    scrub->credit = 0;
+    scrub->lastTick = HAL_GetTick ();
+    scrub->cursor = 0;
+    scrub->address = 0x00;
+    scrub->read.state = MCP_TXN_IDLE;
+    scrub->fix.state = MCP_TXN_IDLE;
+    scrub->fix.mcp = NULL;
+    scrub->fix.done = NULL;
+    scrub->reads = 0;
+    scrub->mismatches = 0;
+    scrub->corrections = 0;
+
+    sched->idle = _scrub_idle;
+    sched->context = scrub;
+    return HAL_OK;
+}
+
+/**
+ *  void MCP41HVX1_Scrub_Set_Shadow(MCP41HVX1_Scrub *scrub, uint8_t index, uint8_t wiper,
+ *                                  uint8_t tcon)
+ *
+ *  Set the wiper code and TCON value a device should hold. Called along
+ *  with every write to the device, a read that raced the write only
+ *  causes a redundant correction. A correction still queued for the
+ *  device carries the old value and is cancelled.
+ */
+void
+MCP41HVX1_Scrub_Set_Shadow (MCP41HVX1_Scrub *scrub, uint8_t index, uint8_t wiper, uint8_t tcon)
+{
+    if (index >= scrub->count)
+    {
+        return;
+    }
+
+    scrub->wiper[index] = wiper;
+    scrub->tcon[index] = tcon;
+    scrub->valid[index] = 1;
+
+    // A correction already running can't be stopped, the next round finds
+    // the old value it leaves behind and corrects it again
+    if (scrub->fix.mcp == scrub->device[index]
+        && MCP41HVX1_Sched_Cancel (scrub->sched, &scrub->fix) == HAL_OK)
+        scrub->corrections--;
+}
@@ -0,0 +1,74 @@
+/**
+ *      MCP41HVX1 STM32F7 SPI Driver - Background Readback Scrubbing
+ *
+ *      Author:     Ethan Garnier
+ *      Date:       2025
+ */
+#ifndef MCP41HVX1_SCRUB_H
+#define MCP41HVX1_SCRUB_H
+
+#include "MCP41HVX1.h"
+#include "MCP41HVX1_Sched.h"
+
+// NOTE(Ethan): A brown-out or glitch can reset a device (wiper back to
+// mid-scale, TCON back to 0xFF) without anything noticing. The scrubber
+// runs as the idle hook of a bus scheduler, reading back the wiper and
+// TCON registers of one device at a time and rewriting any that don't
+// match the values last written (the shadows). Reads only go out while
+// the scheduler's queue is empty, at background priority and one at a
+// time, and are further limited to a share of bus time: every
+// millisecond grants budget percent of it, and each read costs an
+// estimate worked out from the device's SCK frequency.
+
+// Most devices a scrubber watches
+#define MCP_SCRUB_MAX 16
+
+// Fixed cost of a scrub read beyond its 16 clocks, in microseconds
+#define MCP_SCRUB_OVERHEAD_US 5
+
+/* MCP41HVX1 Scrubber Struct */
+typedef struct
+{
+    // Scheduler of the bus the devices are on
+    MCP41HVX1_Sched *sched;
+
+    // Devices watched with the wiper and TCON values they should hold,
+    // only devices whose shadows have been set are read back
+    MCP41HVX1 *device[MCP_SCRUB_MAX];
+    uint8_t wiper[MCP_SCRUB_MAX];
+    uint8_t tcon[MCP_SCRUB_MAX];
+    uint8_t valid[MCP_SCRUB_MAX];
+    uint8_t count;
+
+    // Device and register (0x00 or 0x04) the next read goes to
+    uint8_t cursor;
+    uint8_t address;
+
+    // Read in flight and correcting write, one of each at a time
+    MCP41HVX1_Txn read;
+    MCP41HVX1_Txn fix;
+
+    // Share of bus time scrubbing may use in percent, the estimated cost
+    // of a read and the unspent bus time, all in microseconds
+    uint8_t budget;
+    uint32_t readUs;
+    uint32_t credit;
+    uint32_t lastTick;
+
+    // Reads done, mismatches found and corrections that went out
+    uint32_t reads;
+    uint32_t mismatches;
+    uint32_t corrections;
+} MCP41HVX1_Scrub;
+
+HAL_StatusTypeDef MCP41HVX1_Scrub_Init (MCP41HVX1_Scrub *scrub,
+                                        MCP41HVX1_Sched *sched,
+                                        MCP41HVX1 *const *devices,
+                                        uint8_t count,
+                                        uint8_t budget);
+void MCP41HVX1_Scrub_Set_Shadow (MCP41HVX1_Scrub *scrub,
+                                 uint8_t index,
+                                 uint8_t wiper,
+                                 uint8_t tcon);
+
+#endif
@@ -0,0 +1,377 @@
+/**
+ *      MCP41HVX1 STM32F7 SPI Driver - Persisted Wiper/TCON Snapshots
+ *
+ *      Author:     Ethan Garnier
+ *      Date:       2025
+ */
+#include "MCP41HVX1_Snapshot.h"
+
+#ifdef MCP41HVX1_HOST
+#include "stdio.h"
+#endif
+
+// Bytes of the record covered by its CRC
+#define MCP_SNAPSHOT_CRC_SIZE (sizeof (MCP41HVX1_Snapshot_Record) - sizeof (uint32_t))
+
+// CRC-32 (IEEE 802.3, reflected) a nibble at a time, small enough for
+// flash and fast enough for a record of less than a hundred bytes
+static const uint32_t _snapshot_crc_table[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4,
+    0x4DB26158, 0x5005713C, 0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+    0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+};
+
+static uint32_t
+_snapshot_crc (const uint8_t *data, uint32_t size)
+{
+    uint32_t crc = 0xFFFFFFFF;
+    for (uint32_t i = 0; i < size; i++)
+    {
+        crc = (crc >> 4) ^ _snapshot_crc_table[(crc ^ data[i]) & 0x0F];
+        crc = (crc >> 4) ^ _snapshot_crc_table[(crc ^ (data[i] >> 4)) & 0x0F];
+    }
+
+    return ~crc;
+}
+
+static void
+_snapshot_clear (MCP41HVX1_Snapshot_Record *record)
+{
+    uint8_t *bytes = (uint8_t *)record;
+    for (uint32_t i = 0; i < sizeof (MCP41HVX1_Snapshot_Record); i++)
+        bytes[i] = 0x00;
+}
+
+/**
+ *  HAL_StatusTypeDef MCP41HVX1_Snapshot_Init(MCP41HVX1_Snapshot *snap,
+ *                                            const MCP41HVX1_Snapshot_Store *store,
+ *                                            uint8_t count, uint32_t holdoff,
+ *                                            uint32_t maxAge)
+ *
+ *  Set up a snapshot of count devices kept in store, written holdoff
+ *  milliseconds after the last change or maxAge milliseconds after the
+ *  first unwritten one, whichever comes first, and load it from the
+ *  store. A maxAge of 0 waits for the holdoff only.
+ *
+ *  Returns HAL_OK if an intact snapshot was loaded, HAL_ERROR otherwise.
+ *  Either way the snapshot is ready for use.
+ */
+HAL_StatusTypeDef
+MCP41HVX1_Snapshot_Init (MCP41HVX1_Snapshot *snap,
+                         const MCP41HVX1_Snapshot_Store *store,
+                         uint8_t count,
+                         uint32_t holdoff,
+                         uint32_t maxAge)
+{
+    if (store == NULL || count == 0 || count > MCP_SNAPSHOT_MAX)
+    {
+        return HAL_ERROR;
+    }
+
+    snap->store = store;
+    snap->holdoff = holdoff;
+    snap->maxAge = maxAge;
+    snap->dirty = 0;
+    snap->changed = 0;
+    snap->writes = 0;
+    snap->coalesced = 0;
+
+    _snapshot_clear (&snap->record);
+    snap->record.count = count;
+
+    return MCP41HVX1_Snapshot_Load (snap);
+}
+
+// Whether a record read from slot of the store is intact and holds count
+// devices
+static uint8_t
+_snapshot_read (const MCP41HVX1_Snapshot_Store *store,
+                uint8_t slot,
+                MCP41HVX1_Snapshot_Record *record,
+                uint8_t count)
+{
+    return store->read (store, slot, record, sizeof (MCP41HVX1_Snapshot_Record)) == HAL_OK
+           && record->magic == MCP_SNAPSHOT_MAGIC && record->version == MCP_SNAPSHOT_VERSION
+           && record->count == count
+           && record->crc == _snapshot_crc ((const uint8_t *)record, MCP_SNAPSHOT_CRC_SIZE);
+}
+
+/**
+ *  HAL_StatusTypeDef MCP41HVX1_Snapshot_Load(MCP41HVX1_Snapshot *snap)
+ *
+ *  Read the newest intact record back from the store's two slots,
+ *  discarding any change not yet written. A record that can't be read,
+ *  fails its CRC, was written by another layout version or holds another
+ *  number of devices is ignored.
+ *
+ *  Returns HAL_OK if an intact record was loaded, HAL_ERROR otherwise.
+ */
+HAL_StatusTypeDef
+MCP41HVX1_Snapshot_Load (MCP41HVX1_Snapshot *snap)
+{
+    uint8_t count = snap->record.count;
+    MCP41HVX1_Snapshot_Record *record = &snap->record;
+    MCP41HVX1_Snapshot_Record other;
+
+    snap->valid = 0;
+    snap->dirty = 0;
+    uint8_t first = _snapshot_read (snap->store, 0, record, count);
+    uint8_t second = _snapshot_read (snap->store, 1, &other, count);
+
+    // Sequence numbers are compared as a difference so the newer record
+    // still wins once they wrap
+    if (second && (!first || (int32_t)(other.sequence - record->sequence) > 0))
+    {
+        *record = other;
+        first = 1;
+    }
+
+    if (first)
+    {
+        snap->valid = 1;
+        return HAL_OK;
+    }
+
+    _snapshot_clear (record);
+    record->count = count;
+    return HAL_ERROR;
+}
+
+/**
+ *  HAL_StatusTypeDef MCP41HVX1_Snapshot_Restore(MCP41HVX1_Snapshot *snap,
+ *                                               MCP41HVX1 *const *devices,
+ *                                               MCP41HVX1_Boot_Report *report)
+ *
+ *  Bring the snapshot's devices up with the state it holds for them, or
+ *  at their power-on state if it holds none, in which case the power-on
+ *  state becomes the snapshot. devices must be given in the same order
+ *  every time.
+ *
+ *  Returns the status of MCP41HVX1_Boot.
+ */
+HAL_StatusTypeDef
+MCP41HVX1_Snapshot_Restore (MCP41HVX1_Snapshot *snap,
+                            MCP41HVX1 *const *devices,
+                            MCP41HVX1_Boot_Report *report)
+{
+    if (!snap->valid)
+    {
+        for (uint8_t i = 0; i < snap->record.count; i++)
+        {
+            uint8_t fsv = __MCP_FSV (devices[i]);
+            MCP41HVX1_Snapshot_Set (snap, i, (uint8_t)((fsv + 1) / 2), 0xFF);
+        }
+    }
+
+    return MCP41HVX1_Boot (devices, snap->record.state, snap->record.count, report);
+}
+
+/**
+ *  void MCP41HVX1_Snapshot_Set(MCP41HVX1_Snapshot *snap, uint8_t index, uint8_t wiper,
+ *                              uint8_t tcon)
+ *
+ *  Record the wiper code and TCON value a device was set to. Called along
+ *  with every write to the device, nothing is written to the store until
+ *  the snapshot is flushed.
+ */
+void
+MCP41HVX1_Snapshot_Set (MCP41HVX1_Snapshot *snap, uint8_t index, uint8_t wiper, uint8_t tcon)
+{
+    if (index >= snap->record.count)
+    {
+        return;
+    }
+
+    MCP41HVX1_Boot_State *state = &snap->record.state[index];
+    if (state->wiper == wiper && state->tcon == tcon)
+    {
+        return;
+    }
+
+    state->wiper = wiper;
+    state->tcon = tcon;
+
+    uint32_t now = HAL_GetTick ();
+    if (snap->dirty)
+        snap->coalesced++;
+    else
+        snap->firstChanged = now;
+
+    snap->dirty = 1;
+    snap->changed = now;
+}
+
+/**
+ *  HAL_StatusTypeDef MCP41HVX1_Snapshot_Flush(MCP41HVX1_Snapshot *snap)
+ *
+ *  Write the snapshot to its store if it has changed and either no change
+ *  has come in for the holdoff time or the oldest change has waited for
+ *  maxAge. Called periodically, typically from the main loop.
+ *
+ *  Returns a HAL_StatusTypeDef indicating success or failure.
+ */
+HAL_StatusTypeDef
+MCP41HVX1_Snapshot_Flush (MCP41HVX1_Snapshot *snap)
+{
+    if (!snap->dirty)
+    {
+        return HAL_OK;
+    }
+
+    uint32_t now = HAL_GetTick ();
+    if (now - snap->changed < snap->holdoff
+        && (snap->maxAge == 0 || now - snap->firstChanged < snap->maxAge))
+    {
+        return HAL_OK;
+    }
+
+    return MCP41HVX1_Snapshot_Sync (snap);
+}
+
+/**
+ *  HAL_StatusTypeDef MCP41HVX1_Snapshot_Sync(MCP41HVX1_Snapshot *snap)
+ *
+ *  Write the snapshot to its store now if it has changed, regardless of
+ *  the holdoff time. Meant for when power is about to go (e.g. from the
+ *  PVD interrupt) and before a deliberate reset.
+ *
+ *  Returns a HAL_StatusTypeDef indicating success or failure.
+ */
+HAL_StatusTypeDef
+MCP41HVX1_Snapshot_Sync (MCP41HVX1_Snapshot *snap)
+{
+    if (!snap->dirty)
+    {
+        return HAL_OK;
+    }
+
+    MCP41HVX1_Snapshot_Record *record = &snap->record;
+    record->magic = MCP_SNAPSHOT_MAGIC;
+    record->version = MCP_SNAPSHOT_VERSION;
+    record->sequence++;
+    record->crc = _snapshot_crc ((const uint8_t *)record, MCP_SNAPSHOT_CRC_SIZE);
+
+    // Written over the older of the two slots, the newest record stays
+    // intact until this one is
+    uint8_t slot = (uint8_t)(record->sequence & 1);
+    HAL_StatusTypeDef status =
+        snap->store->write (snap->store, slot, record, sizeof (MCP41HVX1_Snapshot_Record));
+    if (status != HAL_OK)
+    {
+        // The next attempt goes to the same slot, never over the newest
+        record->sequence--;
+        return status;
+    }
+
+    snap->dirty = 0;
+    snap->valid = 1;
+    snap->writes++;
+    return HAL_OK;
+}
+
+#ifndef MCP41HVX1_HOST
+static HAL_StatusTypeDef
+_snapshot_bkpsram_read (const MCP41HVX1_Snapshot_Store *store,
+                        uint8_t slot,
+                        void *data,
+                        uint32_t size)
+{
+    const volatile uint8_t *bkpsram = (const volatile uint8_t *)store->context + slot * size;
+    for (uint32_t i = 0; i < size; i++)
+        ((uint8_t *)data)[i] = bkpsram[i];
+
+    return HAL_OK;
+}
+
+static HAL_StatusTypeDef
+_snapshot_bkpsram_write (const MCP41HVX1_Snapshot_Store *store,
+                         uint8_t slot,
+                         const void *data,
+                         uint32_t size)
+{
+    volatile uint8_t *bkpsram = (volatile uint8_t *)store->context + slot * size;
+    for (uint32_t i = 0; i < size; i++)
+        bkpsram[i] = ((const uint8_t *)data)[i];
+
+    return HAL_OK;
+}
+
+/**
+ *  void MCP41HVX1_Snapshot_Store_Bkpsram(MCP41HVX1_Snapshot_Store *store, uint32_t offset)
+ *
+ *  Set up a store keeping the record's two slots offset bytes into the
+ *  4 KB backup SRAM, taking twice the size of a record. The backup SRAM
+ *  is clocked and its regulator enabled, so with a VBAT supply the
+ *  record also survives power being removed.
+ */
+void
+MCP41HVX1_Snapshot_Store_Bkpsram (MCP41HVX1_Snapshot_Store *store, uint32_t offset)
+{
+    __HAL_RCC_PWR_CLK_ENABLE ();
+    HAL_PWR_EnableBkUpAccess ();
+    __HAL_RCC_BKPSRAM_CLK_ENABLE ();
+    HAL_PWREx_EnableBkUpReg ();
+
+    store->read = _snapshot_bkpsram_read;
+    store->write = _snapshot_bkpsram_write;
+    store->context = (void *)(BKPSRAM_BASE + offset);
+}
+#else
+// Both slots are kept in the one file and each is rewritten in place, as
+// in backup SRAM, so a write cut short tears only the slot being written
+static HAL_StatusTypeDef
+_snapshot_file_read (const MCP41HVX1_Snapshot_Store *store,
+                     uint8_t slot,
+                     void *data,
+                     uint32_t size)
+{
+    FILE *file = fopen ((const char *)store->context, "rb");
+    if (file == NULL)
+    {
+        return HAL_ERROR;
+    }
+
+    size_t read = 0;
+    if (fseek (file, (long)slot * (long)size, SEEK_SET) == 0)
+        read = fread (data, 1, size, file);
+
+    fclose (file);
+    return (read == size) ? HAL_OK : HAL_ERROR;
+}
+
+static HAL_StatusTypeDef
+_snapshot_file_write (const MCP41HVX1_Snapshot_Store *store,
+                      uint8_t slot,
+                      const void *data,
+                      uint32_t size)
+{
+    const char *path = (const char *)store->context;
+    FILE *file = fopen (path, "r+b");
+    if (file == NULL)
+        file = fopen (path, "w+b");
+
+    if (file == NULL)
+    {
+        return HAL_ERROR;
+    }
+
+    size_t written = 0;
+    if (fseek (file, (long)slot * (long)size, SEEK_SET) == 0)
+        written = fwrite (data, 1, size, file);
+
+    if (fclose (file) != 0 || written != size)
+    {
+        return HAL_ERROR;
+    }
+
+    return HAL_OK;
+}
+
+void
+MCP41HVX1_Snapshot_Store_File (MCP41HVX1_Snapshot_Store *store, const char *path)
+{
+    store->read = _snapshot_file_read;
+    store->write = _snapshot_file_write;
+    store->context = (void *)path;
+}
+#endif
@@ -0,0 +1,124 @@
+/**
+ *      MCP41HVX1 STM32F7 SPI Driver - Persisted Wiper/TCON Snapshots
+ *
+ *      Author:     Ethan Garnier
+ *      Date:       2025
+ */
+#ifndef MCP41HVX1_SNAPSHOT_H
+#define MCP41HVX1_SNAPSHOT_H
+
+#include "MCP41HVX1.h"
+#include "MCP41HVX1_Boot.h"
+
+// NOTE(Ethan): A brown-out resets every device to mid-scale, so the wiper
+// code and TCON value of every device are kept in a snapshot that outlives
+// it, and MCP41HVX1_Snapshot_Restore brings the devices back up with them
+// through MCP41HVX1_Boot.
+//
+//  The snapshot is kept as a record in RAM and written to its store
+//  lazily: a change only marks it dirty, setting a value a device already
+//  has changes nothing, and MCP41HVX1_Snapshot_Flush writes it out once no
+//  change has come in for holdoff milliseconds. Every change made within
+//  that time is coalesced into one write, which matters for stores that
+//  wear (flash). Backup SRAM doesn't wear and can take a holdoff of 0.
+//  So that a value that never settles still gets saved, a record is also
+//  written once its oldest unwritten change is maxAge milliseconds old.
+//
+//  The record carries a magic number, a layout version, the number of
+//  devices and a CRC-32 over all of it. A record failing any check is
+//  ignored. Writes alternate between two slots in the store, so a write
+//  torn by a brown-out only ever loses the record being written: the
+//  intact record with the newest sequence number is loaded, and only if
+//  neither slot holds one are the devices brought up at their power-on
+//  state.
+
+// Most devices a snapshot holds
+#define MCP_SNAPSHOT_MAX MCP_BOOT_MAX
+
+// Record magic number ("MCPS") and layout version, bumped whenever the
+// record layout changes
+#define MCP_SNAPSHOT_MAGIC 0x4D435053
+#define MCP_SNAPSHOT_VERSION 1
+
+/* MCP41HVX1 Snapshot Record Struct */
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint8_t count;
+    uint8_t reserved;
+
+    // Incremented on every write, tells how often the store was written
+    // and which slot holds the newest record
+    uint32_t sequence;
+
+    MCP41HVX1_Boot_State state[MCP_SNAPSHOT_MAX];
+
+    // CRC-32 of everything above
+    uint32_t crc;
+} MCP41HVX1_Snapshot_Record;
+
+/* MCP41HVX1 Snapshot Store Struct */
+typedef struct MCP41HVX1_Snapshot_Store
+{
+    // Read or write size bytes of the record in slot 0 or 1, HAL_ERROR if
+    // the store can't be accessed. Writing one slot must leave the other
+    // untouched.
+    HAL_StatusTypeDef (*read) (const struct MCP41HVX1_Snapshot_Store *store,
+                               uint8_t slot,
+                               void *data,
+                               uint32_t size);
+    HAL_StatusTypeDef (*write) (const struct MCP41HVX1_Snapshot_Store *store,
+                                uint8_t slot,
+                                const void *data,
+                                uint32_t size);
+
+    // Where the record is kept, up to the store
+    void *context;
+} MCP41HVX1_Snapshot_Store;
+
+/* MCP41HVX1 Snapshot Struct */
+typedef struct
+{
+    const MCP41HVX1_Snapshot_Store *store;
+    MCP41HVX1_Snapshot_Record record;
+
+    // Whether the record was loaded from the store intact
+    uint8_t valid;
+
+    // Whether the record has changes not yet written, the HAL_GetTick
+    // value of the latest and how long to wait for more, and the
+    // HAL_GetTick value of the oldest and how long it may wait at most
+    uint8_t dirty;
+    uint32_t changed;
+    uint32_t holdoff;
+    uint32_t firstChanged;
+    uint32_t maxAge;
+
+    // Writes made and changes coalesced into a write already pending
+    uint32_t writes;
+    uint32_t coalesced;
+} MCP41HVX1_Snapshot;
+
+HAL_StatusTypeDef MCP41HVX1_Snapshot_Init (MCP41HVX1_Snapshot *snap,
+                                           const MCP41HVX1_Snapshot_Store *store,
+                                           uint8_t count,
+                                           uint32_t holdoff,
+                                           uint32_t maxAge);
+HAL_StatusTypeDef MCP41HVX1_Snapshot_Load (MCP41HVX1_Snapshot *snap);
+HAL_StatusTypeDef MCP41HVX1_Snapshot_Restore (MCP41HVX1_Snapshot *snap,
+                                              MCP41HVX1 *const *devices,
+                                              MCP41HVX1_Boot_Report *report);
+void MCP41HVX1_Snapshot_Set (MCP41HVX1_Snapshot *snap, uint8_t index, uint8_t wiper, uint8_t tcon);
+HAL_StatusTypeDef MCP41HVX1_Snapshot_Flush (MCP41HVX1_Snapshot *snap);
+HAL_StatusTypeDef MCP41HVX1_Snapshot_Sync (MCP41HVX1_Snapshot *snap);
+
+#ifndef MCP41HVX1_HOST
+/* Backup SRAM store, kept on VBAT through resets and brown-outs */
+void MCP41HVX1_Snapshot_Store_Bkpsram (MCP41HVX1_Snapshot_Store *store, uint32_t offset);
+#else
+/* File backed store standing in for backup SRAM on host builds */
+void MCP41HVX1_Snapshot_Store_File (MCP41HVX1_Snapshot_Store *store, const char *path);
+#endif
+
+#endif
@@ -0,0 +1,285 @@
+/**
+ *      MCP41HVX1 STM32F7 SPI Driver - Transports
+ *
+ *      Author:     Ethan Garnier
+ *      Date:       2025
+ */
+#ifndef MCP41HVX1_TRANSPORT_H
+#define MCP41HVX1_TRANSPORT_H
+
+#include "MCP41HVX1.h"
+
+// NOTE(Ethan): A transport moves bytes between the driver and a device.
+// Every command is issued as
+//      acquire, select, transfer..., unselect, release
+//  where acquire takes ownership of the bus and configures it for the
+//  device (SPI mode 0), and transfer exchanges bytes full duplex within the
+//  current chip select frame. Several select/unselect frames may be issued
+//  to devices sharing a bus between one acquire and release.
+//
+//  A transport may hold back transfers and exchange them all at release
+//  (the spidev transport submits a whole burst in one system call), so
+//  tx and rx buffers must stay valid and responses are only looked at
+//  once the bus has been released. A transfer that fails at that point
+//  answers zeros, which reads as CMDERR.
+//
+//  Backends:
+//      Reg   STM32F7 SPI registers, the default (MCP41HVX1.c)
+//      HAL   ST HAL HAL_SPI_TransmitReceive (MCP41HVX1_Transport_HAL.c)
+//      GPIO  bit-banged SPI on plain GPIOs (MCP41HVX1_Transport_GPIO.c)
+//      Sim   simulated device for host builds (MCP41HVX1_Transport_Sim.c)
+//      Spidev  Linux spidev for host builds (MCP41HVX1_Transport_Spidev.c)
+
+/* MCP41HVX1 Transport Struct */
+typedef struct MCP41HVX1_Transport
+{
+    // Take ownership of the bus and configure it for the device,
+    // HAL_BUSY if the bus is owned by someone else
+    HAL_StatusTypeDef (*acquire) (MCP41HVX1 *mcp);
+
+    // Restore the bus configuration and give up ownership
+    void (*release) (MCP41HVX1 *mcp);
+
+    // Assert and deassert the device's chip select
+    void (*select) (MCP41HVX1 *mcp);
+    void (*unselect) (MCP41HVX1 *mcp);
+
+    // Exchange len bytes with the selected device
+    HAL_StatusTypeDef (*transfer) (MCP41HVX1 *mcp, const uint8_t *tx, uint8_t *rx, uint16_t len);
+} MCP41HVX1_Transport;
+
+// NOTE(Ethan): The driver and its modules reach the transport through the
+// macros below. By default the transport is looked up through the function
+// table in the device struct, so every device can use a different one.
+// Defining MCP41HVX1_STATIC_TRANSPORT to a backend name (Reg, HAL, GPIO,
+// Sim or Spidev) instead binds every call to that backend at compile time,
+// which lets the compiler inline the register backend into each command.
+#ifdef MCP41HVX1_STATIC_TRANSPORT
+#define _MCP_CONCAT(a, b, c) a##b##c
+#define _MCP_STATIC(b, op) _MCP_CONCAT (MCP41HVX1_, b, op)
+#define __MCP_ACQUIRE(__MCP__) _MCP_STATIC (MCP41HVX1_STATIC_TRANSPORT, _Acquire) (__MCP__)
+#define __MCP_RELEASE(__MCP__) _MCP_STATIC (MCP41HVX1_STATIC_TRANSPORT, _Release) (__MCP__)
+#define __MCP_XPORT_SELECT(__MCP__) _MCP_STATIC (MCP41HVX1_STATIC_TRANSPORT, _Select) (__MCP__)
+#define __MCP_XPORT_UNSELECT(__MCP__) _MCP_STATIC (MCP41HVX1_STATIC_TRANSPORT, _Unselect) (__MCP__)
+#define __MCP_TRANSFER(__MCP__, __TX__, __RX__, __LEN__)                                           \
+    _MCP_STATIC (MCP41HVX1_STATIC_TRANSPORT, _Transfer) (__MCP__, __TX__, __RX__, __LEN__)
+#else
+#define __MCP_ACQUIRE(__MCP__) ((__MCP__)->transport->acquire (__MCP__))
+#define __MCP_RELEASE(__MCP__) ((__MCP__)->transport->release (__MCP__))
+#define __MCP_XPORT_SELECT(__MCP__) ((__MCP__)->transport->select (__MCP__))
+#define __MCP_XPORT_UNSELECT(__MCP__) ((__MCP__)->transport->unselect (__MCP__))
+#define __MCP_TRANSFER(__MCP__, __TX__, __RX__, __LEN__)                                           \
+    ((__MCP__)->transport->transfer (__MCP__, __TX__, __RX__, __LEN__))
+#endif
+
+/* Register transport, bus context is the SPI_HandleTypeDef */
+extern const MCP41HVX1_Transport MCP41HVX1_Reg_Transport;
+HAL_StatusTypeDef MCP41HVX1_Reg_Acquire (MCP41HVX1 *mcp);
+void MCP41HVX1_Reg_Release (MCP41HVX1 *mcp);
+void MCP41HVX1_Reg_Select (MCP41HVX1 *mcp);
+void MCP41HVX1_Reg_Unselect (MCP41HVX1 *mcp);
+HAL_StatusTypeDef MCP41HVX1_Reg_Transfer (MCP41HVX1 *mcp,
+                                          const uint8_t *tx,
+                                          uint8_t *rx,
+                                          uint16_t len);
+uint32_t MCP41HVX1_Reg_Baud (MCP41HVX1 *mcp);
+
+#ifndef MCP41HVX1_HOST
+#define MCP_HAL_TIMEOUT 10
+
+/* MCP41HVX1 ST HAL Bus Struct */
+typedef struct
+{
+    SPI_HandleTypeDef *spiHandle;
+
+    // Set while a device owns the bus
+    volatile uint8_t lock;
+} MCP41HVX1_HAL_Bus;
+
+/* ST HAL transport, bus context is a MCP41HVX1_HAL_Bus */
+extern const MCP41HVX1_Transport MCP41HVX1_HAL_Transport;
+void MCP41HVX1_HAL_Init (MCP41HVX1_HAL_Bus *bus, SPI_HandleTypeDef *spiHandle);
+HAL_StatusTypeDef MCP41HVX1_HAL_Acquire (MCP41HVX1 *mcp);
+void MCP41HVX1_HAL_Release (MCP41HVX1 *mcp);
+void MCP41HVX1_HAL_Select (MCP41HVX1 *mcp);
+void MCP41HVX1_HAL_Unselect (MCP41HVX1 *mcp);
+HAL_StatusTypeDef MCP41HVX1_HAL_Transfer (MCP41HVX1 *mcp,
+                                          const uint8_t *tx,
+                                          uint8_t *rx,
+                                          uint16_t len);
+#endif
+
+/* MCP41HVX1 Bit-Banged SPI Bus Struct */
+typedef struct
+{
+    // Clock, data out and data in pins, each given as a port and 16 bit pin
+    GPIO_TypeDef *sckPort;
+    uint16_t sckPin;
+    GPIO_TypeDef *mosiPort;
+    uint16_t mosiPin;
+    GPIO_TypeDef *misoPort;
+    uint16_t misoPin;
+
+    // Precomputed by MCP41HVX1_GPIO_Init: BSRR words driving data out low
+    // and high, the clock high, and the clock low (together with data out
+    // low and high when both share a port), and the bit position of data in
+    uint32_t mosi[2];
+    uint32_t sckHigh;
+    uint32_t sckLow[2];
+    uint8_t shared;
+    uint8_t misoShift;
+
+    // Set while a device owns the bus
+    volatile uint8_t lock;
+} MCP41HVX1_GPIO_Bus;
+
+/* Bit-banged GPIO transport, bus context is a MCP41HVX1_GPIO_Bus */
+extern const MCP41HVX1_Transport MCP41HVX1_GPIO_Transport;
+void MCP41HVX1_GPIO_Init (MCP41HVX1_GPIO_Bus *bus,
+                          GPIO_TypeDef *sckPort,
+                          uint16_t sckPin,
+                          GPIO_TypeDef *mosiPort,
+                          uint16_t mosiPin,
+                          GPIO_TypeDef *misoPort,
+                          uint16_t misoPin);
+HAL_StatusTypeDef MCP41HVX1_GPIO_Acquire (MCP41HVX1 *mcp);
+void MCP41HVX1_GPIO_Release (MCP41HVX1 *mcp);
+void MCP41HVX1_GPIO_Select (MCP41HVX1 *mcp);
+void MCP41HVX1_GPIO_Unselect (MCP41HVX1 *mcp);
+HAL_StatusTypeDef MCP41HVX1_GPIO_Transfer (MCP41HVX1 *mcp,
+                                           const uint8_t *tx,
+                                           uint8_t *rx,
+                                           uint16_t len);
+
+// Number of devices a simulated bus can hold. Simulated devices are
+// addressed by using their index as the chip select pin number.
+#define MCP_SIM_MAX_DEVICES 16
+
+/* MCP41HVX1 Simulated Device Struct */
+typedef struct
+{
+    // Full scale code of the simulated part
+    uint8_t fsv;
+
+    // Volatile wiper (0x00) and TCON (0x04) registers
+    uint8_t wiper;
+    uint8_t tcon;
+
+    // Command decoding state within the current frame: whether the first
+    // byte of a 16-bit command has been received and which, and whether
+    // CMDERR has been raised
+    uint8_t pending;
+    uint8_t command;
+    uint8_t error;
+} MCP41HVX1_Sim_Device;
+
+/* MCP41HVX1 Simulated Bus Struct */
+typedef struct
+{
+    MCP41HVX1_Sim_Device device[MCP_SIM_MAX_DEVICES];
+
+    // Set while a device owns the bus
+    uint8_t lock;
+
+    // Index of the device whose chip select is asserted, -1 for none
+    int8_t selected;
+
+    // Traffic counters for comparing transports and command mixes
+    uint32_t acquires;
+    uint32_t frames;
+    uint32_t bytes;
+    uint32_t errors;
+} MCP41HVX1_Sim;
+
+/* Simulated transport, bus context is a MCP41HVX1_Sim */
+extern const MCP41HVX1_Transport MCP41HVX1_Sim_Transport;
+void MCP41HVX1_Sim_Init (MCP41HVX1_Sim *sim, uint8_t fsv);
+void MCP41HVX1_Sim_Power_On_Reset (MCP41HVX1_Sim *sim, uint8_t index);
+HAL_StatusTypeDef MCP41HVX1_Sim_Acquire (MCP41HVX1 *mcp);
+void MCP41HVX1_Sim_Release (MCP41HVX1 *mcp);
+void MCP41HVX1_Sim_Select (MCP41HVX1 *mcp);
+void MCP41HVX1_Sim_Unselect (MCP41HVX1 *mcp);
+HAL_StatusTypeDef MCP41HVX1_Sim_Transfer (MCP41HVX1 *mcp,
+                                          const uint8_t *tx,
+                                          uint8_t *rx,
+                                          uint16_t len);
+
+#if defined(MCP41HVX1_HOST) && defined(__linux__)
+#include "linux/spi/spidev.h"
+
+// Number of spidev nodes a bus can hold. Every device on a Linux host has
+// its own spidev node (one per chip select) and is addressed by using its
+// index into the bus' node table as the chip select pin number.
+#define MCP_SPIDEV_MAX_DEVICES 16
+
+// Transfers and transmit bytes one burst can queue up before it has to be
+// submitted early. Chip select is held across an early submission.
+#define MCP_SPIDEV_MAX_TRANSFERS 64
+#define MCP_SPIDEV_BUFFER_SIZE 512
+
+// ioctl as called by the spidev transport, context is handed through
+// untouched. Swapped out to run the transport without hardware.
+typedef int (*MCP41HVX1_Spidev_Ioctl) (void *context, int fd, unsigned long request, void *arg);
+
+/* MCP41HVX1 Spidev Bus Struct */
+typedef struct
+{
+    // File descriptors of the spidev nodes, -1 for none
+    int fd[MCP_SPIDEV_MAX_DEVICES];
+
+    // SCK frequency transfers are submitted at, lowered to the maxSckHz
+    // of the device each one goes to
+    uint32_t speedHz;
+
+    // ioctl used to reach the nodes and its context
+    MCP41HVX1_Spidev_Ioctl ioctl;
+    void *context;
+
+    // Transfers queued since the bus was acquired, with the device each
+    // one goes to and whether it ends its chip select frame
+    struct spi_ioc_transfer transfer[MCP_SPIDEV_MAX_TRANSFERS];
+    uint8_t device[MCP_SPIDEV_MAX_TRANSFERS];
+    uint8_t frameEnd[MCP_SPIDEV_MAX_TRANSFERS];
+    uint16_t count;
+
+    // Copies of the queued transmit bytes
+    uint8_t tx[MCP_SPIDEV_BUFFER_SIZE];
+    uint16_t used;
+
+    // Index of the device whose chip select is asserted, -1 for none, and
+    // whether its frame has been held open across an early submission
+    int8_t selected;
+    uint8_t held;
+
+    // Set while a device owns the bus
+    uint8_t lock;
+
+    // Nodes opened by MCP41HVX1_Spidev_Open, one bit per index
+    uint16_t opened;
+
+    // System calls made, transfers submitted and submissions failed
+    uint32_t ioctls;
+    uint32_t transfers;
+    uint32_t errors;
+} MCP41HVX1_Spidev_Bus;
+
+/* Spidev transport, bus context is a MCP41HVX1_Spidev_Bus */
+extern const MCP41HVX1_Transport MCP41HVX1_Spidev_Transport;
+void MCP41HVX1_Spidev_Init (MCP41HVX1_Spidev_Bus *bus, uint32_t speedHz);
+HAL_StatusTypeDef MCP41HVX1_Spidev_Open (MCP41HVX1_Spidev_Bus *bus,
+                                         uint8_t index,
+                                         const char *path);
+void MCP41HVX1_Spidev_Close (MCP41HVX1_Spidev_Bus *bus);
+void MCP41HVX1_Spidev_Mock_Init (MCP41HVX1_Spidev_Bus *bus, MCP41HVX1_Sim *sim);
+int MCP41HVX1_Spidev_Mock_Ioctl (void *context, int fd, unsigned long request, void *arg);
+HAL_StatusTypeDef MCP41HVX1_Spidev_Acquire (MCP41HVX1 *mcp);
+void MCP41HVX1_Spidev_Release (MCP41HVX1 *mcp);
+void MCP41HVX1_Spidev_Select (MCP41HVX1 *mcp);
+void MCP41HVX1_Spidev_Unselect (MCP41HVX1 *mcp);
+HAL_StatusTypeDef MCP41HVX1_Spidev_Transfer (MCP41HVX1 *mcp,
+                                             const uint8_t *tx,
+                                             uint8_t *rx,
+                                             uint16_t len);
+#endif
+
+#endif
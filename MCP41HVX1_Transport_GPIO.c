@@ -0,0 +1,166 @@
+/**
+ *      MCP41HVX1 STM32F7 SPI Driver - Bit-Banged GPIO Transport
+ *
+ *      Author:     Ethan Garnier
+ *      Date:       2025
+ */
+#include "MCP41HVX1_Transport.h"
+
+#define __GPIO_BUS(__MCP__) ((MCP41HVX1_GPIO_Bus *)(__MCP__)->bus)
+#define __GPIO_SET(__PORT__, __PIN__) ((__PORT__)->BSRR = (__PIN__))
+#define __GPIO_RESET(__PORT__, __PIN__) ((__PORT__)->BSRR = (uint32_t)(__PIN__) << 16)
+
+// NOTE(Ethan): The clock runs as fast as the ports take BSRR stores, every
+// half period being one or two stores. The MCP41HVX1 needs the clock high
+// and low for at least 45 ns each (10 MHz), which a fast core with the
+// ports on a fast bus can beat. Define MCP_GPIO_DELAY to pad each half
+// period (e.g. with a few __NOP()s) on such a part. MCP41HVX1_Bench.c
+// times the bit loop per bit on a host, for both port layouts.
+#ifndef MCP_GPIO_DELAY
+#define MCP_GPIO_DELAY()
+#endif
+
+// One bit in SPI mode 0, MSB first: data is set up while the clock is low
+// and sampled by both sides on the rising edge. When the clock and data out
+// share a port the falling edge and the next data bit are one store.
+#define _GPIO_BIT_SHARED(__N__)                                                                    \
+    *sck = sckLow[(out >> (__N__)) & 1];                                                           \
+    MCP_GPIO_DELAY ();                                                                             \
+    *sck = sckHigh;                                                                                \
+    in = (in << 1) | ((*miso >> misoShift) & 1);                                                   \
+    MCP_GPIO_DELAY ();
+
+#define _GPIO_BIT_SPLIT(__N__)                                                                     \
+    *mosi = mosiWord[(out >> (__N__)) & 1];                                                        \
+    MCP_GPIO_DELAY ();                                                                             \
+    *sck = sckHigh;                                                                                \
+    in = (in << 1) | ((*miso >> misoShift) & 1);                                                   \
+    MCP_GPIO_DELAY ();                                                                             \
+    *sck = sckLow;
+
+#define _GPIO_BYTE(__BIT__)                                                                        \
+    __BIT__ (7) __BIT__ (6) __BIT__ (5) __BIT__ (4) __BIT__ (3) __BIT__ (2) __BIT__ (1) __BIT__ (0)
+
+/**
+ *  void MCP41HVX1_GPIO_Init(MCP41HVX1_GPIO_Bus *bus, GPIO_TypeDef *sckPort, uint16_t sckPin,
+ *                           GPIO_TypeDef *mosiPort, uint16_t mosiPin,
+ *                           GPIO_TypeDef *misoPort, uint16_t misoPin)
+ *
+ *  Set up a bit-banged bus on the given pins, which must already be
+ *  configured as push-pull outputs (clock, data out) and an input (data
+ *  in). The BSRR words the transfer loop stores are worked out here once.
+ */
+void
+MCP41HVX1_GPIO_Init (MCP41HVX1_GPIO_Bus *bus,
+                     GPIO_TypeDef *sckPort,
+                     uint16_t sckPin,
+                     GPIO_TypeDef *mosiPort,
+                     uint16_t mosiPin,
+                     GPIO_TypeDef *misoPort,
+                     uint16_t misoPin)
+{
+    bus->sckPort = sckPort;
+    bus->sckPin = sckPin;
+    bus->mosiPort = mosiPort;
+    bus->mosiPin = mosiPin;
+    bus->misoPort = misoPort;
+    bus->misoPin = misoPin;
+
+    bus->mosi[0] = (uint32_t)mosiPin << 16;
+    bus->mosi[1] = mosiPin;
+    bus->sckHigh = sckPin;
+    bus->shared = (sckPort == mosiPort);
+    bus->sckLow[0] = ((uint32_t)sckPin << 16) | (bus->shared ? bus->mosi[0] : 0);
+    bus->sckLow[1] = ((uint32_t)sckPin << 16) | (bus->shared ? bus->mosi[1] : 0);
+
+    bus->misoShift = 0;
+    while (misoPin > 1)
+    {
+        misoPin >>= 1;
+        bus->misoShift++;
+    }
+
+    bus->lock = 0;
+}
+
+HAL_StatusTypeDef
+MCP41HVX1_GPIO_Acquire (MCP41HVX1 *mcp)
+{
+    MCP41HVX1_GPIO_Bus *bus = __GPIO_BUS (mcp);
+    if (bus->lock)
+    {
+        return HAL_BUSY;
+    }
+
+    bus->lock = 1;
+
+    // SPI mode 0, the clock idles low
+    __GPIO_RESET (bus->sckPort, bus->sckPin);
+    return HAL_OK;
+}
+
+void
+MCP41HVX1_GPIO_Release (MCP41HVX1 *mcp)
+{
+    __GPIO_BUS (mcp)->lock = 0;
+}
+
+void
+MCP41HVX1_GPIO_Select (MCP41HVX1 *mcp)
+{
+    __GPIO_RESET (mcp->csPort, mcp->csPin);
+}
+
+void
+MCP41HVX1_GPIO_Unselect (MCP41HVX1 *mcp)
+{
+    __GPIO_SET (mcp->csPort, mcp->csPin);
+}
+
+HAL_StatusTypeDef
+MCP41HVX1_GPIO_Transfer (MCP41HVX1 *mcp, const uint8_t *tx, uint8_t *rx, uint16_t len)
+{
+    MCP41HVX1_GPIO_Bus *bus = __GPIO_BUS (mcp);
+
+    // Everything the loop touches is pulled into locals so the compiler
+    // can keep it in registers across the volatile port accesses
+    volatile uint32_t *sck = &bus->sckPort->BSRR;
+    volatile uint32_t *mosi = &bus->mosiPort->BSRR;
+    volatile uint32_t *miso = &bus->misoPort->IDR;
+    const uint32_t sckHigh = bus->sckHigh;
+    const uint32_t misoShift = bus->misoShift;
+
+    if (bus->shared)
+    {
+        const uint32_t sckLow[2] = { bus->sckLow[0], bus->sckLow[1] };
+        for (uint16_t i = 0; i < len; i++)
+        {
+            uint32_t out = tx[i];
+            uint32_t in = 0;
+            _GPIO_BYTE (_GPIO_BIT_SHARED)
+            rx[i] = (uint8_t)in;
+        }
+
+        // Each bit leaves the clock high, bring it back to idle
+        *sck = sckLow[0];
+    }
+    else
+    {
+        const uint32_t mosiWord[2] = { bus->mosi[0], bus->mosi[1] };
+        const uint32_t sckLow = bus->sckLow[0];
+        for (uint16_t i = 0; i < len; i++)
+        {
+            uint32_t out = tx[i];
+            uint32_t in = 0;
+            _GPIO_BYTE (_GPIO_BIT_SPLIT)
+            rx[i] = (uint8_t)in;
+        }
+    }
+
+    return HAL_OK;
+}
+
+const MCP41HVX1_Transport MCP41HVX1_GPIO_Transport = {
+    MCP41HVX1_GPIO_Acquire, MCP41HVX1_GPIO_Release,  MCP41HVX1_GPIO_Select,
+    MCP41HVX1_GPIO_Unselect, MCP41HVX1_GPIO_Transfer,
+};
@@ -0,0 +1,103 @@
+/**
+ *      MCP41HVX1 STM32F7 SPI Driver - ST HAL Transport
+ *
+ *      Author:     Ethan Garnier
+ *      Date:       2025
+ */
+#include "MCP41HVX1_Transport.h"
+
+#ifndef MCP41HVX1_HOST
+// NOTE(Ethan): HAL_SPI_TransmitReceive takes the handle's lock itself for
+// each transfer, and the handle's State goes back to ready after each one,
+// so neither can hold the bus between acquire and release like the
+// register transport does. Ownership is instead a lock in the bus struct
+// kept next to the handle, claimed with interrupts masked so a thread and
+// an interrupt can't both take it. The CPOL/CPHA and baud rate bits the
+// handle was configured with are saved in the device to be restored on
+// release.
+
+#define __HAL_BUS(__MCP__) ((MCP41HVX1_HAL_Bus *)(__MCP__)->bus)
+
+/**
+ *  void MCP41HVX1_HAL_Init(MCP41HVX1_HAL_Bus *bus, SPI_HandleTypeDef *spiHandle)
+ *
+ *  Set up a bus driven through the ST HAL on an SPI handle already
+ *  initialized with HAL_SPI_Init. Every device on the handle must be
+ *  given the same bus.
+ */
+void
+MCP41HVX1_HAL_Init (MCP41HVX1_HAL_Bus *bus, SPI_HandleTypeDef *spiHandle)
+{
+    bus->spiHandle = spiHandle;
+    bus->lock = 0;
+}
+
+HAL_StatusTypeDef
+MCP41HVX1_HAL_Acquire (MCP41HVX1 *mcp)
+{
+    MCP41HVX1_HAL_Bus *bus = __HAL_BUS (mcp);
+    SPI_HandleTypeDef *spiHandle = bus->spiHandle;
+
+    uint32_t primask = __get_PRIMASK ();
+    __disable_irq ();
+    uint8_t owned = bus->lock;
+    bus->lock = 1;
+    __set_PRIMASK (primask);
+
+    if (owned)
+    {
+        return HAL_BUSY;
+    }
+
+    // The handle may still be in use by code outside the driver
+    if (spiHandle->State != HAL_SPI_STATE_READY)
+    {
+        bus->lock = 0;
+        return HAL_BUSY;
+    }
+
+    // CPOL, CPHA and BR can only be changed while the SPI is disabled
+    __HAL_SPI_DISABLE (spiHandle);
+    uint32_t baud = MCP41HVX1_Reg_Baud (mcp);
+    mcp->spiMode = spiHandle->Instance->CR1 & (SPI_CR1_CPOL | SPI_CR1_CPHA | SPI_CR1_BR);
+    spiHandle->Instance->CR1 &= ~(SPI_CR1_CPOL | SPI_CR1_CPHA | SPI_CR1_BR);
+    spiHandle->Instance->CR1 |= baud;
+
+    return HAL_OK;
+}
+
+void
+MCP41HVX1_HAL_Release (MCP41HVX1 *mcp)
+{
+    SPI_HandleTypeDef *spiHandle = mcp->spiHandle;
+
+    __HAL_SPI_DISABLE (spiHandle);
+    spiHandle->Instance->CR1 &= ~(SPI_CR1_CPOL | SPI_CR1_CPHA | SPI_CR1_BR);
+    spiHandle->Instance->CR1 |= mcp->spiMode;
+
+    __HAL_BUS (mcp)->lock = 0;
+}
+
+void
+MCP41HVX1_HAL_Select (MCP41HVX1 *mcp)
+{
+    HAL_GPIO_WritePin (mcp->csPort, mcp->csPin, GPIO_PIN_RESET);
+}
+
+void
+MCP41HVX1_HAL_Unselect (MCP41HVX1 *mcp)
+{
+    HAL_GPIO_WritePin (mcp->csPort, mcp->csPin, GPIO_PIN_SET);
+}
+
+HAL_StatusTypeDef
+MCP41HVX1_HAL_Transfer (MCP41HVX1 *mcp, const uint8_t *tx, uint8_t *rx, uint16_t len)
+{
+    return HAL_SPI_TransmitReceive (mcp->spiHandle, (uint8_t *)tx, rx, len, MCP_HAL_TIMEOUT);
+}
+
+const MCP41HVX1_Transport MCP41HVX1_HAL_Transport = {
+    MCP41HVX1_HAL_Acquire, MCP41HVX1_HAL_Release,  MCP41HVX1_HAL_Select,
+    MCP41HVX1_HAL_Unselect, MCP41HVX1_HAL_Transfer,
+};
+#endif
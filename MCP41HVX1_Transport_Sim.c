@@ -0,0 +1,166 @@
+/**
+ *      MCP41HVX1 STM32F7 SPI Driver - Simulated Device Transport
+ *
+ *      Author:     Ethan Garnier
+ *      Date:       2025
+ */
+#include "MCP41HVX1_Transport.h"
+
+// NOTE(Ethan): Models the SPI command set of the MCP41HVX1 closely enough
+// to run the driver on a host. Every command starts with a byte holding
+// the register address in bits 7:4 and the command in bits 3:2:
+//      00 write data (16-bit), 01 increment, 10 decrement, 11 read (16-bit)
+//  The device answers the command byte with all ones, except CMDERR (bit 1)
+//  which is low for an invalid command. After an error the device ignores
+//  everything, answering zeros, until chip select is raised again.
+
+#define __SIM_BUS(__MCP__) ((MCP41HVX1_Sim *)(__MCP__)->bus)
+
+void
+MCP41HVX1_Sim_Init (MCP41HVX1_Sim *sim, uint8_t fsv)
+{
+    for (uint8_t i = 0; i < MCP_SIM_MAX_DEVICES; i++)
+    {
+        sim->device[i].fsv = fsv;
+        MCP41HVX1_Sim_Power_On_Reset (sim, i);
+    }
+
+    sim->lock = 0;
+    sim->selected = -1;
+    sim->acquires = 0;
+    sim->frames = 0;
+    sim->bytes = 0;
+    sim->errors = 0;
+}
+
+void
+MCP41HVX1_Sim_Power_On_Reset (MCP41HVX1_Sim *sim, uint8_t index)
+{
+    // Wiper comes back at mid-scale with every terminal connected
+    MCP41HVX1_Sim_Device *device = &sim->device[index];
+    device->wiper = (device->fsv + 1) / 2;
+    device->tcon = 0xFF;
+    device->pending = 0;
+    device->command = 0x00;
+    device->error = 0;
+}
+
+static uint8_t *
+_sim_register (MCP41HVX1_Sim_Device *device, uint8_t address)
+{
+    if (address == 0x00)
+        return &device->wiper;
+
+    if (address == 0x04)
+        return &device->tcon;
+
+    return NULL;
+}
+
+static uint8_t
+_sim_exchange (MCP41HVX1_Sim *sim, MCP41HVX1_Sim_Device *device, uint8_t tx)
+{
+    if (device->error)
+        return 0x00;
+
+    // Second byte of a 16-bit command
+    if (device->pending)
+    {
+        uint8_t command = device->command;
+        uint8_t *reg = _sim_register (device, (command >> 4) & 0x0F);
+        device->pending = 0;
+
+        if ((command & 0x0C) == 0x0C)
+            return *reg;
+
+        *reg = (reg == &device->wiper && tx > device->fsv) ? device->fsv : tx;
+        return 0xFF;
+    }
+
+    uint8_t *reg = _sim_register (device, (tx >> 4) & 0x0F);
+    uint8_t op = tx & 0x0C;
+
+    // Increment and decrement only exist for the wiper register
+    if (reg == NULL || ((op == 0x04 || op == 0x08) && reg != &device->wiper))
+    {
+        device->error = 1;
+        sim->errors++;
+        return 0xFD;
+    }
+
+    if (op == 0x04 && device->wiper < device->fsv)
+        device->wiper++;
+    else if (op == 0x08 && device->wiper > 0)
+        device->wiper--;
+    else if (op == 0x00 || op == 0x0C)
+    {
+        device->pending = 1;
+        device->command = tx;
+    }
+
+    return 0xFF;
+}
+
+HAL_StatusTypeDef
+MCP41HVX1_Sim_Acquire (MCP41HVX1 *mcp)
+{
+    MCP41HVX1_Sim *sim = __SIM_BUS (mcp);
+    if (sim->lock)
+    {
+        return HAL_BUSY;
+    }
+
+    sim->lock = 1;
+    sim->acquires++;
+    return HAL_OK;
+}
+
+void
+MCP41HVX1_Sim_Release (MCP41HVX1 *mcp)
+{
+    __SIM_BUS (mcp)->lock = 0;
+}
+
+void
+MCP41HVX1_Sim_Select (MCP41HVX1 *mcp)
+{
+    MCP41HVX1_Sim *sim = __SIM_BUS (mcp);
+    sim->selected = (mcp->csPin < MCP_SIM_MAX_DEVICES) ? (int8_t)mcp->csPin : -1;
+    sim->frames++;
+}
+
+void
+MCP41HVX1_Sim_Unselect (MCP41HVX1 *mcp)
+{
+    MCP41HVX1_Sim *sim = __SIM_BUS (mcp);
+
+    // Raising chip select aborts any partial command and clears CMDERR
+    if (sim->selected >= 0)
+    {
+        sim->device[sim->selected].pending = 0;
+        sim->device[sim->selected].error = 0;
+    }
+
+    sim->selected = -1;
+}
+
+HAL_StatusTypeDef
+MCP41HVX1_Sim_Transfer (MCP41HVX1 *mcp, const uint8_t *tx, uint8_t *rx, uint16_t len)
+{
+    MCP41HVX1_Sim *sim = __SIM_BUS (mcp);
+
+    for (uint16_t i = 0; i < len; i++)
+    {
+        // Nothing drives the data line without a selected device
+        rx[i] = (sim->selected < 0) ? 0xFF
+                                    : _sim_exchange (sim, &sim->device[sim->selected], tx[i]);
+    }
+
+    sim->bytes += len;
+    return HAL_OK;
+}
+
+const MCP41HVX1_Transport MCP41HVX1_Sim_Transport = {
+    MCP41HVX1_Sim_Acquire, MCP41HVX1_Sim_Release,  MCP41HVX1_Sim_Select,
+    MCP41HVX1_Sim_Unselect, MCP41HVX1_Sim_Transfer,
+};
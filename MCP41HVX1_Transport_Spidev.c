@@ -0,0 +1,360 @@
+/**
+ *      MCP41HVX1 STM32F7 SPI Driver - Linux Spidev Transport
+ *
+ *      Author:     Ethan Garnier
+ *      Date:       2025
+ */
+#include "MCP41HVX1_Transport.h"
+
+#if defined(MCP41HVX1_HOST) && defined(__linux__)
+#include "errno.h"
+#include "fcntl.h"
+#include "string.h"
+#include "sys/ioctl.h"
+#include "unistd.h"
+
+// NOTE(Ethan): Every transfer costs a system call when handed to spidev one
+// at a time, which dominates the few microseconds it takes to clock out a
+// command. Instead transfers are queued up between acquire and release and
+// submitted together with SPI_IOC_MESSAGE, one message per spidev node.
+// Chip select frames are kept apart within a message by cs_change:
+//      between transfers   cs_change deasserts chip select after the transfer
+//      on the last one     cs_change keeps chip select asserted past it
+//  so a burst of commands to a device costs one kernel crossing however
+//  many frames it spans. Devices on separate nodes still need one each.
+
+#define __SPIDEV_BUS(__MCP__) ((MCP41HVX1_Spidev_Bus *)(__MCP__)->bus)
+
+static int
+_spidev_ioctl (void *context, int fd, unsigned long request, void *arg)
+{
+    (void)context;
+    return ioctl (fd, request, arg);
+}
+
+void
+MCP41HVX1_Spidev_Init (MCP41HVX1_Spidev_Bus *bus, uint32_t speedHz)
+{
+    for (uint8_t i = 0; i < MCP_SPIDEV_MAX_DEVICES; i++)
+        bus->fd[i] = -1;
+
+    bus->speedHz = speedHz;
+    bus->ioctl = _spidev_ioctl;
+    bus->context = NULL;
+    bus->count = 0;
+    bus->used = 0;
+    bus->selected = -1;
+    bus->held = 0;
+    bus->lock = 0;
+    bus->opened = 0;
+    bus->ioctls = 0;
+    bus->transfers = 0;
+    bus->errors = 0;
+}
+
+/**
+ *  HAL_StatusTypeDef MCP41HVX1_Spidev_Open(MCP41HVX1_Spidev_Bus *bus, uint8_t index,
+ *                                          const char *path)
+ *
+ *  Open the spidev node at path (e.g. /dev/spidev0.1) as device index of
+ *  the bus and set it up for SPI mode 0, 8 bit words at the bus' speed.
+ *
+ *  Returns a HAL_StatusTypeDef indicating success or failure.
+ */
+HAL_StatusTypeDef
+MCP41HVX1_Spidev_Open (MCP41HVX1_Spidev_Bus *bus, uint8_t index, const char *path)
+{
+    if (index >= MCP_SPIDEV_MAX_DEVICES || bus->fd[index] >= 0)
+    {
+        return HAL_ERROR;
+    }
+
+    int fd = open (path, O_RDWR);
+    if (fd < 0)
+    {
+        return HAL_ERROR;
+    }
+
+    uint8_t mode = SPI_MODE_0;
+    uint8_t bits = 8;
+    if (bus->ioctl (bus->context, fd, SPI_IOC_WR_MODE, &mode) < 0
+        || bus->ioctl (bus->context, fd, SPI_IOC_WR_BITS_PER_WORD, &bits) < 0
+        || (bus->speedHz
+            && bus->ioctl (bus->context, fd, SPI_IOC_WR_MAX_SPEED_HZ, &bus->speedHz) < 0))
+    {
+        close (fd);
+        return HAL_ERROR;
+    }
+
+    bus->fd[index] = fd;
+    bus->opened |= (uint16_t)(1u << index);
+    return HAL_OK;
+}
+
+void
+MCP41HVX1_Spidev_Close (MCP41HVX1_Spidev_Bus *bus)
+{
+    for (uint8_t i = 0; i < MCP_SPIDEV_MAX_DEVICES; i++)
+    {
+        if (bus->opened & (1u << i))
+        {
+            close (bus->fd[i]);
+            bus->fd[i] = -1;
+        }
+    }
+
+    bus->opened = 0;
+}
+
+/**
+ *  void MCP41HVX1_Spidev_Mock_Init(MCP41HVX1_Spidev_Bus *bus, MCP41HVX1_Sim *sim)
+ *
+ *  Set up a bus whose ioctls are answered by the simulated devices of sim
+ *  instead of the kernel, device index i being sim's device i. Lets the
+ *  spidev transport, message batching included, run without hardware.
+ */
+void
+MCP41HVX1_Spidev_Mock_Init (MCP41HVX1_Spidev_Bus *bus, MCP41HVX1_Sim *sim)
+{
+    MCP41HVX1_Spidev_Init (bus, 0);
+
+    for (uint8_t i = 0; i < MCP_SPIDEV_MAX_DEVICES; i++)
+        bus->fd[i] = i;
+
+    bus->ioctl = MCP41HVX1_Spidev_Mock_Ioctl;
+    bus->context = sim;
+}
+
+int
+MCP41HVX1_Spidev_Mock_Ioctl (void *context, int fd, unsigned long request, void *arg)
+{
+    MCP41HVX1_Sim *sim = (MCP41HVX1_Sim *)context;
+    if (fd < 0 || fd >= MCP_SPIDEV_MAX_DEVICES)
+    {
+        errno = EBADF;
+        return -1;
+    }
+
+    if (_IOC_TYPE (request) != SPI_IOC_MAGIC)
+    {
+        errno = ENOTTY;
+        return -1;
+    }
+
+    // Mode, word size and speed settings are accepted as they are
+    if (_IOC_NR (request) != 0 || _IOC_DIR (request) != _IOC_WRITE)
+    {
+        return 0;
+    }
+
+    // Drive the simulated device through the sim transport itself
+    MCP41HVX1 mcp = { 0 };
+    mcp.csPin = (uint16_t)fd;
+    mcp.bus = sim;
+
+    const struct spi_ioc_transfer *transfer = (const struct spi_ioc_transfer *)arg;
+    uint32_t count = _IOC_SIZE (request) / sizeof (struct spi_ioc_transfer);
+    int total = 0;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const uint8_t *tx = (const uint8_t *)(uintptr_t)transfer[i].tx_buf;
+        uint8_t *rx = (uint8_t *)(uintptr_t)transfer[i].rx_buf;
+
+        if (sim->selected != fd)
+            MCP41HVX1_Sim_Select (&mcp);
+
+        // A missing buffer shifts out zeros or drops what comes back
+        for (uint32_t j = 0; j < transfer[i].len; j++)
+        {
+            uint8_t out = tx ? tx[j] : 0x00;
+            uint8_t in = 0x00;
+            MCP41HVX1_Sim_Transfer (&mcp, &out, &in, 1);
+            if (rx)
+                rx[j] = in;
+        }
+
+        total += (int)transfer[i].len;
+
+        if (transfer[i].cs_change != (i + 1 == count))
+            MCP41HVX1_Sim_Unselect (&mcp);
+    }
+
+    return total;
+}
+
+/**
+ *  void _spidev_submit(MCP41HVX1_Spidev_Bus *bus)
+ *
+ *  Submit every queued transfer, one message per run of transfers going to
+ *  the same node. The last frame is held open past the submission when it
+ *  hasn't been ended yet. A failed message answers zeros in place of its
+ *  responses, which reads as CMDERR.
+ */
+static void
+_spidev_submit (MCP41HVX1_Spidev_Bus *bus)
+{
+    if (bus->count == 0)
+    {
+        return;
+    }
+
+    uint16_t start = 0;
+    while (start < bus->count)
+    {
+        uint8_t device = bus->device[start];
+        uint16_t end = start + 1;
+        while (end < bus->count && bus->device[end] == device)
+            end++;
+
+        for (uint16_t i = start; i < end; i++)
+        {
+            bus->transfer[i].cs_change = (i + 1 < end) ? bus->frameEnd[i] : !bus->frameEnd[i];
+        }
+
+        int result = bus->ioctl (bus->context,
+                                 bus->fd[device],
+                                 SPI_IOC_MESSAGE (end - start),
+                                 &bus->transfer[start]);
+        bus->ioctls++;
+        bus->transfers += end - start;
+
+        if (result < 0)
+        {
+            bus->errors++;
+            for (uint16_t i = start; i < end; i++)
+            {
+                if (bus->transfer[i].rx_buf)
+                    memset ((void *)(uintptr_t)bus->transfer[i].rx_buf, 0, bus->transfer[i].len);
+            }
+        }
+
+        start = end;
+    }
+
+    bus->held = !bus->frameEnd[bus->count - 1];
+    bus->count = 0;
+    bus->used = 0;
+}
+
+// Bus speed lowered to the device's own limit, as the on-chip transports
+// derive SCK per device. 0 is the node's default speed.
+static uint32_t
+_spidev_speed (const MCP41HVX1_Spidev_Bus *bus, const MCP41HVX1 *mcp)
+{
+    uint32_t hz = bus->speedHz;
+    if (mcp->maxSckHz && (hz == 0 || mcp->maxSckHz < hz))
+        hz = mcp->maxSckHz;
+
+    return hz;
+}
+
+static void
+_spidev_queue (MCP41HVX1_Spidev_Bus *bus,
+               const uint8_t *tx,
+               uint8_t *rx,
+               uint16_t len,
+               uint32_t speedHz)
+{
+    if (bus->count == MCP_SPIDEV_MAX_TRANSFERS || bus->used + len > MCP_SPIDEV_BUFFER_SIZE)
+        _spidev_submit (bus);
+
+    // The caller's transmit bytes may not outlive the call, keep a copy
+    struct spi_ioc_transfer *transfer = &bus->transfer[bus->count];
+    memset (transfer, 0, sizeof (*transfer));
+    if (len)
+    {
+        memcpy (&bus->tx[bus->used], tx, len);
+        transfer->tx_buf = (uintptr_t)&bus->tx[bus->used];
+        transfer->rx_buf = (uintptr_t)rx;
+    }
+    transfer->len = len;
+    transfer->speed_hz = speedHz;
+    transfer->bits_per_word = 8;
+
+    bus->device[bus->count] = (uint8_t)bus->selected;
+    bus->frameEnd[bus->count] = 0;
+    bus->count++;
+    bus->used += len;
+}
+
+HAL_StatusTypeDef
+MCP41HVX1_Spidev_Acquire (MCP41HVX1 *mcp)
+{
+    MCP41HVX1_Spidev_Bus *bus = __SPIDEV_BUS (mcp);
+    if (bus->lock)
+    {
+        return HAL_BUSY;
+    }
+
+    bus->lock = 1;
+    bus->count = 0;
+    bus->used = 0;
+    bus->selected = -1;
+    bus->held = 0;
+    return HAL_OK;
+}
+
+void
+MCP41HVX1_Spidev_Release (MCP41HVX1 *mcp)
+{
+    MCP41HVX1_Spidev_Bus *bus = __SPIDEV_BUS (mcp);
+
+    _spidev_submit (bus);
+    bus->lock = 0;
+}
+
+void
+MCP41HVX1_Spidev_Select (MCP41HVX1 *mcp)
+{
+    MCP41HVX1_Spidev_Bus *bus = __SPIDEV_BUS (mcp);
+    uint8_t valid = mcp->csPin < MCP_SPIDEV_MAX_DEVICES && bus->fd[mcp->csPin] >= 0;
+    bus->selected = valid ? (int8_t)mcp->csPin : -1;
+}
+
+void
+MCP41HVX1_Spidev_Unselect (MCP41HVX1 *mcp)
+{
+    MCP41HVX1_Spidev_Bus *bus = __SPIDEV_BUS (mcp);
+    if (bus->selected < 0)
+    {
+        return;
+    }
+
+    // End the frame on its last queued transfer. A frame held open across
+    // an early submission with nothing queued since is ended by an empty
+    // transfer instead.
+    if (bus->count > 0 && bus->device[bus->count - 1] == (uint8_t)bus->selected)
+        bus->frameEnd[bus->count - 1] = 1;
+    else if (bus->held)
+    {
+        _spidev_queue (bus, NULL, NULL, 0, _spidev_speed (bus, mcp));
+        bus->frameEnd[bus->count - 1] = 1;
+    }
+
+    bus->held = 0;
+    bus->selected = -1;
+}
+
+HAL_StatusTypeDef
+MCP41HVX1_Spidev_Transfer (MCP41HVX1 *mcp, const uint8_t *tx, uint8_t *rx, uint16_t len)
+{
+    MCP41HVX1_Spidev_Bus *bus = __SPIDEV_BUS (mcp);
+    if (bus->selected < 0 || len > MCP_SPIDEV_BUFFER_SIZE)
+    {
+        return HAL_ERROR;
+    }
+
+    if (len == 0)
+    {
+        return HAL_OK;
+    }
+
+    _spidev_queue (bus, tx, rx, len, _spidev_speed (bus, mcp));
+    return HAL_OK;
+}
+
+const MCP41HVX1_Transport MCP41HVX1_Spidev_Transport = {
+    MCP41HVX1_Spidev_Acquire, MCP41HVX1_Spidev_Release,  MCP41HVX1_Spidev_Select,
+    MCP41HVX1_Spidev_Unselect, MCP41HVX1_Spidev_Transfer,
+};
+#endif
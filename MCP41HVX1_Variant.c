@@ -0,0 +1,78 @@
+/**
+ *      MCP41HVX1 STM32F7 SPI Driver - Device Variants
+ *
+ *      Author:     Ethan Garnier
+ *      Date:       2025
+ */
+#include "MCP41HVX1_Variant.h"
+
+// Compile-time expansion of a resistance table, the A to wiper resistance
+// (FSV - code) * Rab / FSV rounded to the nearest milliohm
+#define _MCP_R(fsv, rab, c) ((uint32_t)((((uint64_t)((fsv) - (c)) * (rab)) + (fsv) / 2) / (fsv)))
+#define _MCP_R_4(fsv, rab, c)                                                                      \
+    _MCP_R (fsv, rab, c), _MCP_R (fsv, rab, (c) + 1), _MCP_R (fsv, rab, (c) + 2),                  \
+        _MCP_R (fsv, rab, (c) + 3)
+#define _MCP_R_16(fsv, rab, c)                                                                     \
+    _MCP_R_4 (fsv, rab, c), _MCP_R_4 (fsv, rab, (c) + 4), _MCP_R_4 (fsv, rab, (c) + 8),            \
+        _MCP_R_4 (fsv, rab, (c) + 12)
+#define _MCP_R_64(fsv, rab, c)                                                                     \
+    _MCP_R_16 (fsv, rab, c), _MCP_R_16 (fsv, rab, (c) + 16), _MCP_R_16 (fsv, rab, (c) + 32),       \
+        _MCP_R_16 (fsv, rab, (c) + 48)
+#define _MCP_R_128(fsv, rab, c) _MCP_R_64 (fsv, rab, c), _MCP_R_64 (fsv, rab, (c) + 64)
+#define _MCP_R_256(fsv, rab, c) _MCP_R_128 (fsv, rab, c), _MCP_R_128 (fsv, rab, (c) + 128)
+
+static const uint32_t _mcp41hv51_5k_table[256] = { _MCP_R_256 (255, 5000000, 0) };
+const MCP41HVX1_Variant MCP41HV51_5K = { 255, 5000000, _mcp41hv51_5k_table };
+
+static const uint32_t _mcp41hv51_10k_table[256] = { _MCP_R_256 (255, 10000000, 0) };
+const MCP41HVX1_Variant MCP41HV51_10K = { 255, 10000000, _mcp41hv51_10k_table };
+
+static const uint32_t _mcp41hv51_50k_table[256] = { _MCP_R_256 (255, 50000000, 0) };
+const MCP41HVX1_Variant MCP41HV51_50K = { 255, 50000000, _mcp41hv51_50k_table };
+
+static const uint32_t _mcp41hv51_100k_table[256] = { _MCP_R_256 (255, 100000000, 0) };
+const MCP41HVX1_Variant MCP41HV51_100K = { 255, 100000000, _mcp41hv51_100k_table };
+
+static const uint32_t _mcp41hv31_5k_table[128] = { _MCP_R_128 (127, 5000000, 0) };
+const MCP41HVX1_Variant MCP41HV31_5K = { 127, 5000000, _mcp41hv31_5k_table };
+
+static const uint32_t _mcp41hv31_10k_table[128] = { _MCP_R_128 (127, 10000000, 0) };
+const MCP41HVX1_Variant MCP41HV31_10K = { 127, 10000000, _mcp41hv31_10k_table };
+
+static const uint32_t _mcp41hv31_50k_table[128] = { _MCP_R_128 (127, 50000000, 0) };
+const MCP41HVX1_Variant MCP41HV31_50K = { 127, 50000000, _mcp41hv31_50k_table };
+
+static const uint32_t _mcp41hv31_100k_table[128] = { _MCP_R_128 (127, 100000000, 0) };
+const MCP41HVX1_Variant MCP41HV31_100K = { 127, 100000000, _mcp41hv31_100k_table };
+
+void
+MCP41HVX1_Set_Variant (MCP41HVX1 *mcp, const MCP41HVX1_Variant *variant)
+{
+    mcp->variant = variant;
+}
+
+// Devices without a variant are fitted with the default 8-bit 50k part
+static const MCP41HVX1_Variant *
+_variant_of (MCP41HVX1 *mcp)
+{
+    const MCP41HVX1_Variant *variant = __MCP_VARIANT (mcp);
+    return variant ? variant : &MCP41HV51_50K;
+}
+
+HAL_StatusTypeDef
+MCP41HVX1_Variant_Set_Resistance (MCP41HVX1 *mcp, uint32_t milliohms)
+{
+    uint8_t code = MCP41HVX1_Variant_To_Code (_variant_of (mcp), milliohms);
+    return MCP41HVX1_Set_Resistance_Code (mcp, code);
+}
+
+HAL_StatusTypeDef
+MCP41HVX1_Variant_Get_Resistance (MCP41HVX1 *mcp, uint32_t *milliohms)
+{
+    uint8_t code;
+    HAL_StatusTypeDef status = MCP41HVX1_Get_Resistance_Code (mcp, &code);
+    if (status == HAL_OK)
+        *milliohms = MCP41HVX1_Variant_To_Milliohms (_variant_of (mcp), code);
+
+    return status;
+}
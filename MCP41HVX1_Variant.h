@@ -0,0 +1,36 @@
+/**
+ *      MCP41HVX1 STM32F7 SPI Driver - Device Variants
+ *
+ *      Author:     Ethan Garnier
+ *      Date:       2025
+ */
+#ifndef MCP41HVX1_VARIANT_H
+#define MCP41HVX1_VARIANT_H
+
+#include "MCP41HVX1.h"
+
+// NOTE(Ethan): The MCP41HVX1 family comes as the 7-bit MCP41HV31 and the
+// 8-bit MCP41HV51, each with an Rab of 5k, 10k, 50k or 100k. Each variant
+// below carries its own resistance table, generated at compile time and
+// kept in flash, so conversions are a table lookup or a binary search
+// with no division at runtime. A variant is selected per device with
+// MCP41HVX1_Set_Variant, from then on the driver's resistance conversions
+// and code clamps follow it. Boards fitted with a single part can define
+// MCP41HVX1_FIXED_VARIANT to its name (e.g. MCP41HV31_10K) to resolve the
+// variant of every device at compile time instead.
+extern const MCP41HVX1_Variant MCP41HV51_5K;
+extern const MCP41HVX1_Variant MCP41HV51_10K;
+extern const MCP41HVX1_Variant MCP41HV51_50K;
+extern const MCP41HVX1_Variant MCP41HV51_100K;
+extern const MCP41HVX1_Variant MCP41HV31_5K;
+extern const MCP41HVX1_Variant MCP41HV31_10K;
+extern const MCP41HVX1_Variant MCP41HV31_50K;
+extern const MCP41HVX1_Variant MCP41HV31_100K;
+
+void MCP41HVX1_Set_Variant (MCP41HVX1 *mcp, const MCP41HVX1_Variant *variant);
+uint32_t MCP41HVX1_Variant_To_Milliohms (const MCP41HVX1_Variant *variant, uint8_t code);
+uint8_t MCP41HVX1_Variant_To_Code (const MCP41HVX1_Variant *variant, uint32_t milliohms);
+HAL_StatusTypeDef MCP41HVX1_Variant_Set_Resistance (MCP41HVX1 *mcp, uint32_t milliohms);
+HAL_StatusTypeDef MCP41HVX1_Variant_Get_Resistance (MCP41HVX1 *mcp, uint32_t *milliohms);
+
+#endif
@@ -0,0 +1,116 @@
+/**
+ *      MCP41HVX1 STM32F7 SPI Driver - Audio Taper Volume Control
+ *
+ *      Author:     Ethan Garnier
+ *      Date:       2025
+ */
+#include "MCP41HVX1_Volume.h"
+
+// Generated offline with round(200 * log10(code / 255)), clamped to
+// MCP_VOLUME_MIN. Being const it lives in flash with the code.
+const int16_t MCP41HVX1_Volume_Table[MCP_FSV + 1] = {
+    MCP_VOLUME_MUTE, -481, -421, -386, -361, -342, -326, -312, -301, -290, -281, -273,
+    -265, -259, -252, -246, -240, -235, -230, -226, -221, -217, -213, -209,
+    -205, -202, -198, -195, -192, -189, -186, -183, -180, -178, -175, -172,
+    -170, -168, -165, -163, -161, -159, -157, -155, -153, -151, -149, -147,
+    -145, -143, -142, -140, -138, -136, -135, -133, -132, -130, -129, -127,
+    -126, -124, -123, -121, -120, -119, -117, -116, -115, -114, -112, -111,
+    -110, -109, -107, -106, -105, -104, -103, -102, -101, -100, -99, -97,
+    -96, -95, -94, -93, -92, -91, -90, -89, -89, -88, -87, -86,
+    -85, -84, -83, -82, -81, -80, -80, -79, -78, -77, -76, -75,
+    -75, -74, -73, -72, -71, -71, -70, -69, -68, -68, -67, -66,
+    -65, -65, -64, -63, -63, -62, -61, -61, -60, -59, -59, -58,
+    -57, -57, -56, -55, -55, -54, -53, -53, -52, -51, -51, -50,
+    -50, -49, -48, -48, -47, -47, -46, -46, -45, -44, -44, -43,
+    -43, -42, -42, -41, -40, -40, -39, -39, -38, -38, -37, -37,
+    -36, -36, -35, -35, -34, -34, -33, -33, -32, -32, -31, -31,
+    -30, -30, -29, -29, -28, -28, -27, -27, -26, -26, -26, -25,
+    -25, -24, -24, -23, -23, -22, -22, -22, -21, -21, -20, -20,
+    -19, -19, -19, -18, -18, -17, -17, -16, -16, -16, -15, -15,
+    -14, -14, -14, -13, -13, -12, -12, -12, -11, -11, -10, -10,
+    -10, -9, -9, -9, -8, -8, -7, -7, -7, -6, -6, -6,
+    -5, -5, -5, -4, -4, -3, -3, -3, -2, -2, -2, -1,
+    -1, -1, 0, 0,
+};
+
+/**
+ *  uint8_t MCP41HVX1_Volume_To_Code(int16_t decibels)
+ *
+ *  Find the code whose gain is closest to the requested volume in tenths
+ *  of a dB with a binary search of the taper table. Volumes below
+ *  MCP_VOLUME_MIN mute the output.
+ *
+ *  Returns the code for the volume.
+ */
+uint8_t
+MCP41HVX1_Volume_To_Code (int16_t decibels)
+{
+    if (decibels < MCP_VOLUME_MIN)
+    {
+        return 0;
+    }
+
+    if (decibels >= MCP_VOLUME_MAX)
+    {
+        return MCP_FSV;
+    }
+
+    // First non-muted code with a gain not below the request
+    uint16_t low = 1;
+    uint16_t high = MCP_FSV;
+    while (low < high)
+    {
+        uint16_t mid = (low + high) / 2;
+        if (MCP41HVX1_Volume_Table[mid] < decibels)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    if (low > 1
+        && decibels - MCP41HVX1_Volume_Table[low - 1] < MCP41HVX1_Volume_Table[low] - decibels)
+        return (uint8_t)(low - 1);
+
+    return (uint8_t)low;
+}
+
+int16_t
+MCP41HVX1_Volume_To_Decibels (uint8_t code)
+{
+    return MCP41HVX1_Volume_Table[code];
+}
+
+/**
+ *  HAL_StatusTypeDef MCP41HVX1_Volume_Init(MCP41HVX1_Volume *volume, MCP41HVX1 *mcp,
+ *                                          int16_t decibels, uint8_t maxSteps)
+ *
+ *  Initialize a volume control at the given volume. Later volume changes
+ *  walk the wiper at most maxSteps codes per call to MCP41HVX1_Volume_Tick,
+ *  each tick being a single chip select frame of increment/decrement
+ *  commands, so there are no audible jumps (zipper noise).
+ *
+ *  Returns a HAL_StatusTypeDef indicating success or failure.
+ */
+HAL_StatusTypeDef
+MCP41HVX1_Volume_Init (MCP41HVX1_Volume *volume, MCP41HVX1 *mcp, int16_t decibels, uint8_t maxSteps)
+{
+    // The taper table spans the 8-bit range, a 7-bit part tops out at its
+    // own full scale
+    uint8_t code = MCP41HVX1_Volume_To_Code (decibels);
+    volume->decibels = decibels;
+    return MCP41HVX1_Ramp_Init (&volume->ramp, mcp, __MCP_CLAMP_CODE (mcp, code), maxSteps);
+}
+
+void
+MCP41HVX1_Volume_Set (MCP41HVX1_Volume *volume, int16_t decibels)
+{
+    uint8_t code = MCP41HVX1_Volume_To_Code (decibels);
+    volume->decibels = decibels;
+    MCP41HVX1_Ramp_Set_Target (&volume->ramp, __MCP_CLAMP_CODE (volume->ramp.mcp, code));
+}
+
+HAL_StatusTypeDef
+MCP41HVX1_Volume_Tick (MCP41HVX1_Volume *volume)
+{
+    return MCP41HVX1_Ramp_Tick (&volume->ramp);
+}
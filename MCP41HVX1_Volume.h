@@ -0,0 +1,45 @@
+/**
+ *      MCP41HVX1 STM32F7 SPI Driver - Audio Taper Volume Control
+ *
+ *      Author:     Ethan Garnier
+ *      Date:       2025
+ */
+#ifndef MCP41HVX1_VOLUME_H
+#define MCP41HVX1_VOLUME_H
+
+#include "MCP41HVX1.h"
+#include "MCP41HVX1_Ramp.h"
+
+// NOTE(Ethan): The pot is used as an attenuator with the input on terminal
+// A, ground on B and the output on the wiper, so the gain of a code is
+//      G = 20 * log10(code / FSV) dB
+//  Volumes are given in tenths of a dB, from MCP_VOLUME_MIN (-60.0 dB) to
+//  0 (0.0 dB). With only 8 bits the steps near the bottom of the range are
+//  coarse, the quietest non-muted code is about -48.1 dB.
+#define MCP_VOLUME_MIN (-600)
+#define MCP_VOLUME_MAX 0
+#define MCP_VOLUME_MUTE (-32768)
+
+// Gain in tenths of a dB of every code, MCP_VOLUME_MUTE for code 0
+extern const int16_t MCP41HVX1_Volume_Table[MCP_FSV + 1];
+
+/* MCP41HVX1 Volume Control Struct */
+typedef struct
+{
+    // Ramp engine walking the wiper between volumes
+    MCP41HVX1_Ramp ramp;
+
+    // Requested volume in tenths of a dB
+    int16_t decibels;
+} MCP41HVX1_Volume;
+
+uint8_t MCP41HVX1_Volume_To_Code (int16_t decibels);
+int16_t MCP41HVX1_Volume_To_Decibels (uint8_t code);
+HAL_StatusTypeDef MCP41HVX1_Volume_Init (MCP41HVX1_Volume *volume,
+                                         MCP41HVX1 *mcp,
+                                         int16_t decibels,
+                                         uint8_t maxSteps);
+void MCP41HVX1_Volume_Set (MCP41HVX1_Volume *volume, int16_t decibels);
+HAL_StatusTypeDef MCP41HVX1_Volume_Tick (MCP41HVX1_Volume *volume);
+
+#endif
@@ -0,0 +1,258 @@
+/**
+ *      MCP41HVX1 STM32F7 SPI Driver - Delta Encoded Waveforms
+ *
+ *      Author:     Ethan Garnier
+ *      Date:       2025
+ */
+#include "MCP41HVX1_Wave.h"
+
+static void
+_wave_put_u32 (uint8_t *buffer, uint32_t value)
+{
+    buffer[0] = (uint8_t)(value & 0xFF);
+    buffer[1] = (uint8_t)((value >> 8) & 0xFF);
+    buffer[2] = (uint8_t)((value >> 16) & 0xFF);
+    buffer[3] = (uint8_t)((value >> 24) & 0xFF);
+}
+
+static uint32_t
+_wave_get_u32 (const uint8_t *buffer)
+{
+    return (uint32_t)buffer[0] | ((uint32_t)buffer[1] << 8) | ((uint32_t)buffer[2] << 16)
+           | ((uint32_t)buffer[3] << 24);
+}
+
+static uint8_t
+_wave_header_valid (const uint8_t *program, uint32_t size)
+{
+    return size >= MCP_WAVE_HEADER_SIZE && program[0] == 'M' && program[1] == 'W'
+           && program[2] == MCP_WAVE_VERSION;
+}
+
+/**
+ *  uint32_t MCP41HVX1_Wave_Compile(const uint8_t *codes, uint32_t count, uint32_t tickUs,
+ *                                  uint8_t *program, uint32_t size)
+ *
+ *  Compile a sequence of wiper codes, one per tick of tickUs microseconds,
+ *  into the cheapest stream of ops: single steps become 8-bit INCR/DECR
+ *  commands, repeated codes cost no bus traffic at all, and only larger
+ *  jumps fall back to a 16-bit absolute write. Runs of the same op are
+ *  merged into one byte.
+ *
+ *  Returns the number of bytes written to program, or 0 if count is zero or
+ *  the program does not fit in size bytes.
+ */
+uint32_t
+MCP41HVX1_Wave_Compile (const uint8_t *codes,
+                        uint32_t count,
+                        uint32_t tickUs,
+                        uint8_t *program,
+                        uint32_t size)
+{
+    if (count == 0 || size < MCP_WAVE_HEADER_SIZE + 2)
+    {
+        return 0;
+    }
+
+    program[0] = 'M';
+    program[1] = 'W';
+    program[2] = MCP_WAVE_VERSION;
+    program[3] = 0x00;
+    _wave_put_u32 (&program[4], tickUs);
+    _wave_put_u32 (&program[8], count);
+
+    // The first sample is always absolute, the wiper state is unknown
+    uint32_t length = MCP_WAVE_HEADER_SIZE;
+    program[length++] = WAVE_OP_SET;
+    program[length++] = codes[0];
+
+    // Offset of the last run op, so following samples can extend it
+    uint32_t run = 0;
+
+    for (uint32_t i = 1; i < count; i++)
+    {
+        int16_t delta = (int16_t)codes[i] - (int16_t)codes[i - 1];
+        uint8_t op;
+
+        if (delta == 1)
+            op = WAVE_OP_INCR;
+        else if (delta == -1)
+            op = WAVE_OP_DECR;
+        else if (delta == 0)
+            op = WAVE_OP_HOLD;
+        else
+        {
+            if (length + 2 > size)
+                return 0;
+
+            program[length++] = WAVE_OP_SET;
+            program[length++] = codes[i];
+            run = 0;
+            continue;
+        }
+
+        if (run && (program[run] & 0xC0) == op && (program[run] & 0x3F) < MCP_WAVE_MAX_RUN - 1)
+        {
+            program[run]++;
+            continue;
+        }
+
+        if (length + 1 > size)
+            return 0;
+
+        run = length;
+        program[length++] = op;
+    }
+
+    return length;
+}
+
+/**
+ *  uint32_t MCP41HVX1_Wave_Decode(const uint8_t *program, uint32_t size,
+ *                                 uint8_t *codes, uint32_t max)
+ *
+ *  Expand a compiled waveform back into one code per tick, which is what
+ *  the wiper holds after each tick of the player.
+ *
+ *  Returns the number of codes written, or 0 if the program is malformed.
+ */
+uint32_t
+MCP41HVX1_Wave_Decode (const uint8_t *program, uint32_t size, uint8_t *codes, uint32_t max)
+{
+    if (!_wave_header_valid (program, size))
+    {
+        return 0;
+    }
+
+    uint32_t count = 0;
+    uint8_t code = 0;
+
+    for (uint32_t offset = MCP_WAVE_HEADER_SIZE; offset < size; offset++)
+    {
+        uint8_t op = program[offset] & 0xC0;
+        uint8_t ticks = (program[offset] & 0x3F) + 1;
+
+        if (op == WAVE_OP_SET)
+        {
+            if (++offset >= size)
+                return 0;
+
+            code = program[offset];
+            ticks = 1;
+        }
+
+        for (uint8_t t = 0; t < ticks && count < max; t++)
+        {
+            if (op == WAVE_OP_INCR)
+                code++;
+            else if (op == WAVE_OP_DECR)
+                code--;
+
+            codes[count++] = code;
+        }
+    }
+
+    return count;
+}
+
+uint32_t
+MCP41HVX1_Wave_Tick_Us (const uint8_t *program)
+{
+    return _wave_get_u32 (&program[4]);
+}
+
+HAL_StatusTypeDef
+MCP41HVX1_Wave_Player_Init (MCP41HVX1_Wave_Player *player,
+                            MCP41HVX1 *mcp,
+                            const uint8_t *program,
+                            uint32_t size)
+{
+    if (!_wave_header_valid (program, size))
+    {
+        return HAL_ERROR;
+    }
+
+    player->mcp = mcp;
+    player->program = program;
+    player->size = size;
+    player->offset = MCP_WAVE_HEADER_SIZE;
+    player->op = WAVE_OP_HOLD;
+    player->remaining = 0;
+    player->code = 0;
+
+    return HAL_OK;
+}
+
+/**
+ *  HAL_StatusTypeDef MCP41HVX1_Wave_Player_Tick(MCP41HVX1_Wave_Player *player)
+ *
+ *  Play one sample of the waveform. Intended to be called from a timer
+ *  interrupt running at the program's tick period. At most one command is
+ *  sent per tick and nothing is sent while the code holds.
+ *
+ *  Returns a HAL_StatusTypeDef indicating success or failure. HAL_BUSY is
+ *  returned if the SPI bus was locked, in which case the tick is not consumed.
+ *  Any other failure consumes the tick without moving the tracked code.
+ */
+HAL_StatusTypeDef
+MCP41HVX1_Wave_Player_Tick (MCP41HVX1_Wave_Player *player)
+{
+    if (player->remaining == 0)
+    {
+        if (player->offset >= player->size)
+            return HAL_OK;
+
+        uint8_t op = player->program[player->offset];
+        player->op = op & 0xC0;
+        player->remaining = (op & 0x3F) + 1;
+
+        if (player->op == WAVE_OP_SET)
+        {
+            if (player->offset + 1 >= player->size)
+                return HAL_ERROR;
+
+            player->remaining = 1;
+        }
+    }
+
+    HAL_StatusTypeDef status = HAL_OK;
+    uint8_t code = player->code;
+
+    switch (player->op)
+    {
+    case WAVE_OP_INCR:
+        status = MCP41HVX1_Move_Wiper (player->mcp, INCR_WIPER);
+        code++;
+        break;
+    case WAVE_OP_DECR:
+        status = MCP41HVX1_Move_Wiper (player->mcp, DECR_WIPER);
+        code--;
+        break;
+    case WAVE_OP_SET:
+        code = player->program[player->offset + 1];
+        status = MCP41HVX1_Set_Resistance_Code (player->mcp, code);
+        break;
+    default:
+        break;
+    }
+
+    // A locked bus leaves the tick pending so it can be retried
+    if (status == HAL_BUSY)
+        return status;
+
+    // A failed command didn't move the wiper, the tick is spent but the
+    // code the player tracks stays where the wiper is
+    if (status == HAL_OK)
+        player->code = code;
+
+    if (--player->remaining == 0)
+        player->offset += (player->op == WAVE_OP_SET) ? 2 : 1;
+
+    return status;
+}
+
+uint8_t
+MCP41HVX1_Wave_Player_Done (MCP41HVX1_Wave_Player *player)
+{
+    return player->remaining == 0 && player->offset >= player->size;
+}
@@ -0,0 +1,79 @@
+/**
+ *      MCP41HVX1 STM32F7 SPI Driver - Delta Encoded Waveforms
+ *
+ *      Author:     Ethan Garnier
+ *      Date:       2025
+ */
+#ifndef MCP41HVX1_WAVE_H
+#define MCP41HVX1_WAVE_H
+
+#include "stdint.h"
+
+// NOTE(Ethan): A compiled waveform is a 12 byte header followed by a
+// stream of one or two byte ops. Every sample of the original code
+// sequence takes exactly one tick of the player:
+//
+//      header:     'M' 'W' version 0x00 tickUs[4] sampleCount[4]
+//      0b00nnnnnn: n + 1 ticks, each sending one INCR_WIPER (8-bit frame)
+//      0b01nnnnnn: n + 1 ticks, each sending one DECR_WIPER (8-bit frame)
+//      0b10nnnnnn: n + 1 ticks with no bus traffic (code unchanged)
+//      0b11000000 code: one tick sending an absolute wiper write (16-bit frame)
+//
+//  Multi-byte header fields are little endian. Slow ramps, where consecutive
+//  codes differ by one, compile down to a single byte per 64 samples.
+#define MCP_WAVE_VERSION 1
+#define MCP_WAVE_HEADER_SIZE 12
+#define MCP_WAVE_MAX_RUN 64
+
+/* MCP41HVX1 Waveform Op Codes */
+typedef enum
+{
+    WAVE_OP_INCR = 0x00,
+    WAVE_OP_DECR = 0x40,
+    WAVE_OP_HOLD = 0x80,
+    WAVE_OP_SET = 0xC0,
+} MCP41HVX1_Wave_Op;
+
+// Host side compiler and decoder, these only depend on stdint.h
+uint32_t MCP41HVX1_Wave_Compile (const uint8_t *codes,
+                                 uint32_t count,
+                                 uint32_t tickUs,
+                                 uint8_t *program,
+                                 uint32_t size);
+uint32_t MCP41HVX1_Wave_Decode (const uint8_t *program,
+                                uint32_t size,
+                                uint8_t *codes,
+                                uint32_t max);
+uint32_t MCP41HVX1_Wave_Tick_Us (const uint8_t *program);
+
+#include "MCP41HVX1.h"
+
+/* MCP41HVX1 Waveform Player Struct */
+typedef struct
+{
+    // Device the waveform is being played to
+    MCP41HVX1 *mcp;
+
+    // Compiled waveform and its size in bytes
+    const uint8_t *program;
+    uint32_t size;
+
+    // Offset of the next op to fetch from the program
+    uint32_t offset;
+
+    // Op currently being played and the ticks it has left
+    uint8_t op;
+    uint8_t remaining;
+
+    // Code the wiper is expected to hold after the last tick
+    uint8_t code;
+} MCP41HVX1_Wave_Player;
+
+HAL_StatusTypeDef MCP41HVX1_Wave_Player_Init (MCP41HVX1_Wave_Player *player,
+                                              MCP41HVX1 *mcp,
+                                              const uint8_t *program,
+                                              uint32_t size);
+HAL_StatusTypeDef MCP41HVX1_Wave_Player_Tick (MCP41HVX1_Wave_Player *player);
+uint8_t MCP41HVX1_Wave_Player_Done (MCP41HVX1_Wave_Player *player);
+
+#endif